@@ -19,17 +19,34 @@
 //-------------------------------------------------------------------------//
 #include <map>
 #include <deque>
+#include <memory>
+#include <string>
 #include <atomic>
 #include <thread>
-#include <future>
+#include <chrono>
+#include <algorithm>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
+#include <iostream>
+#include <cassert>
 //-------------------------------------------------------------------------//
 #include "concurrency-queue.h"
 #include "concurrency-map.h"
+#include "concurrency-pool.h"
+#include "concurrency-slot.h"
+#include "storage-codec.h"
+#include "storage-overflow.h"
+#ifdef MULTIQUEUE_STORAGE
+#include "storage-spill.h"
+#include "storage-snapshot.h"
+#endif // MULTIQUEUE_STORAGE
+#include "storage-message.h"
+#include "diagnostics-trace.h"
+#include "coroutine-task.h"
 //-------------------------------------------------------------------------//
 #define MAXCAPACITY 1000
+#define DISPATCH_BATCH 64
 //-------------------------------------------------------------------------//
 namespace multiqueue
 {
@@ -41,32 +58,268 @@ namespace multiqueue
 
         virtual auto Consume(const Key & id, const Value & value) -> void = 0;
     };
+//-------------------------------------------------------------------------//
+#ifdef MULTIQUEUE_COROUTINES
+    template<typename Key, typename Value>
+    struct IAsyncConsumer
+    {
+        using key_type = Key;
+        using value_type = Value;
+
+        /**
+         * Proceeds a message, the next message of key is not passed until the task completes.
+         * @param id [in] - A key, it is kept while the task runs.
+         * @param value [in] - A message, it is kept while the task runs.
+         * @return A task.
+         */
+        virtual auto Consume(const Key & id, const Value & value) -> coroutine::task = 0;
+    };
+//-------------------------------------------------------------------------//
+#endif // MULTIQUEUE_COROUTINES
+    template<typename Key, typename Value>
+    struct Options
+    {
+        //!< Keeps a max count of messages kept in memory per key.
+        size_t capacity = MAXCAPACITY;
+        //!< Keeps a codec of keys (required by snapshots).
+        std::shared_ptr<ICodec<Key>> keys;
+        //!< Keeps a codec of messages (required by overflow and snapshots).
+        std::shared_ptr<ICodec<Value>> codec;
+        //!< Keeps a count of snapshot shards, 0 - a count of hardware threads.
+        size_t shards = 0;
+        //!< Keeps a directory of overflow segments, the overflow is disabled if empty.
+        std::string overflow;
+        //!< Keeps a size of overflow segment.
+        size_t segment = SPILL_SEGMENT_SIZE;
+        //!< Keeps a max count of drained overflow segments kept for reuse per key.
+        size_t spare = SPILL_SPARE_SEGMENTS;
+        //!< Keeps a min count of dispatching threads.
+        size_t minimum = 1;
+        //!< Keeps a max count of dispatching threads, 0 - a count of hardware threads.
+        size_t maximum = 0;
+        //!< Keeps a count of keys waiting for dispatch per thread, beyond which a thread is added.
+        size_t backlog = 4;
+        //!< Keeps a waiting time of key for dispatch, beyond which a thread is added.
+        std::chrono::microseconds latency = std::chrono::microseconds(500);
+        //!< Keeps an idle time, after which a thread above the minimum retires.
+        std::chrono::milliseconds idle = std::chrono::milliseconds(1000);
+        //!< Keeps a time budget of Consume, beyond which a consumer is isolated, 0 - no isolation.
+        std::chrono::microseconds budget = std::chrono::microseconds(10000);
+        //!< Keeps a max count of dispatching threads of isolated consumers.
+        size_t isolation = 4;
+    };
 //-------------------------------------------------------------------------//
     template<typename Key, typename Value>
     class MultiQueueProcessor final
     {
         using mutex_guard_t = std::unique_lock<std::mutex>;
-        using consumers_t = concurrency::map<Key, IConsumer<Key, Value> *>;
         using deque_t = concurrency::queue<Value>;
-        using queues_t = concurrency::map<Key, deque_t>;
+        using options_t = Options<Key, Value>;
+#ifdef MULTIQUEUE_COROUTINES
+        using async_guard_t = typename concurrency::slot<IAsyncConsumer<Key, Value>>::guard;
+
+    public:
+        class Awaiter;
+
+    private:
+#endif // MULTIQUEUE_COROUTINES
+        struct channel final
+        {
+            channel(const Key & key, deque_t && queue) : key(key), queue(std::move(queue)), scheduled(false), isolated(false), average(0)
+            {
+            }
+            //!< Keeps a key, it is passed to the consumer without lookups.
+            const Key key;
+            //!< Keeps messages.
+            deque_t queue;
+            //!< Keeps a flag of waiting for dispatch or being dispatched.
+            std::atomic_bool scheduled;
+            //!< Keeps a flag of dispatching on the isolation threads.
+            std::atomic_bool isolated;
+            //!< Keeps a moving average time of Consume in nanoseconds.
+            std::atomic<int64_t> average;
+            //!< Keeps a consumer, it is read by dispatching threads without locks.
+            concurrency::slot<IConsumer<Key, Value>> consumer;
+#ifdef MULTIQUEUE_COROUTINES
+            //!< Keeps an asynchronous consumer, it is read by dispatching threads without locks.
+            concurrency::slot<IAsyncConsumer<Key, Value>> asynchronous;
+            //!< Keeps a mutex of waiters.
+            std::mutex lock;
+            //!< Keeps coroutines, which wait for messages by Next.
+            std::deque<Awaiter *> waiters;
+            //!< Keeps coroutines, which have got messages and wait for dispatching threads to resume them.
+            std::deque<Awaiter *> ready;
+            //!< Keeps a count of waiters, it is read by producers without the lock.
+            std::atomic<size_t> awaiting{0};
+#endif // MULTIQUEUE_COROUTINES
+        };
+        using channel_t = std::shared_ptr<channel>;
+        using queues_t = concurrency::map<Key, channel_t>;
+
+        struct inflight final
+        {
+            //!< Keeps a channel being dispatched on shared threads, nullptr - the slot is free.
+            std::atomic<channel *> object{nullptr};
+            //!< Keeps a start time of Consume in nanoseconds, 0 - Consume is not running, -1 - the budget is overrun.
+            std::atomic<int64_t> started{0};
+        };
+
+    public:
+        /**
+         * An interned key, which refers to the queue of key, so messages are added without lookups of key.
+         * It is valid for the processor, which has made it, while the processor exists.
+         */
+        class Handle final
+        {
+            friend class MultiQueueProcessor;
+            //!< Keeps a channel of key.
+            channel_t object;
+
+            explicit Handle(channel_t object) : object(std::move(object))
+            {
+            }
+
+        public:
+            //!< Constructor.
+            Handle() = default;
+
+            /**
+             * Gets a key.
+             * @return A key.
+             */
+            auto key() const -> const Key &
+            {
+                return this->object->key;
+            }
+
+            explicit operator bool() const { return this->object != nullptr; }
+        };
+#ifdef MULTIQUEUE_COROUTINES
+        /**
+         * An awaitable of the next message of key, a coroutine waits for it without a thread.
+         * It throws std::runtime_error, if the processing is stopped before a message comes.
+         */
+        class Awaiter final
+        {
+            friend class MultiQueueProcessor;
+            //!< Keeps a channel of key.
+            channel_t object;
+            //!< Keeps a flag of running processor.
+            const std::atomic_bool * running;
+            //!< Keeps a suspended coroutine.
+            std::coroutine_handle<> handle;
+            //!< Keeps a message.
+            Value value;
+            //!< Keeps a flag of no message, since the processing is stopped.
+            bool stopped = false;
+
+            Awaiter(channel_t object, const std::atomic_bool * running) : object(std::move(object)), running(running)
+            {
+            }
+
+        public:
+            auto await_ready() -> bool
+            {
+                return this->take();
+            }
+
+            auto await_suspend(std::coroutine_handle<> handle) -> bool
+            {
+                this->handle = handle;
+
+                std::unique_lock<std::mutex> sync(this->object->lock);
+                // Producers check waiters after adding a message, so it is taken either here or by a producer.
+                ++this->object->awaiting;
+
+                if (this->take() != false)
+                {
+                    --this->object->awaiting;
+                    return false;
+                }
+                if (*this->running != true)
+                {// Nobody resumes a coroutine, which is parked after the processing is stopped.
+                    this->stopped = true;
+                    --this->object->awaiting;
+                    return false;
+                }
+                this->object->waiters.push_back(this);
+
+                return true;
+            }
+
+            auto await_resume() -> Value
+            {
+                if (this->stopped != false) { throw (std::runtime_error("The processing is stopped.")); }
+
+                return std::move(this->value);
+            }
+
+        protected:
+            //!< Takes the first message of key, returns false if there is no one.
+            auto take() -> bool
+            {
+                if (this->object->queue.empty() != false) { return false; }
+
+                try
+                {
+                    this->value = this->object->queue.dequeue();
+                }
+                catch (const std::out_of_range &)
+                {
+                    return false;
+                }
+                diagnostics::trace::instant(diagnostics::event::dequeue, this->object.get());
+
+                return true;
+            }
+        };
+#endif // MULTIQUEUE_COROUTINES
 
     protected:
-        //!< Keeps a map of consumers.
-        consumers_t consumers;
+        //!< Keeps options.
+        const options_t options;
         //!< Keeps a map of messages (key, messages).
         queues_t queues;
         //!< Keeps a flag of stopped or not.
         std::atomic_bool running;
-        std::thread thread;
+        //!< Keeps dispatching threads.
+        concurrency::pool workers;
+        //!< Keeps dispatching threads of consumers, which exceed the time budget.
+        concurrency::pool isolation;
+        //!< Keeps a count of slots of running Consume.
+        const size_t slots;
+        //!< Keeps slots of running Consume on shared threads, they are scanned by the watchdog.
+        std::unique_ptr<inflight[]> inflights;
+        //!< Keeps a count of taken slots, the watchdog sleeps without timeouts, while it is 0.
+        std::atomic<size_t> taken{0};
+        //!< Keeps a thread, which isolates a consumer, while its Consume overruns the time budget.
+        std::thread watchdog;
+        //!< Keeps a mutex of watchdog.
+        std::mutex guard;
+        std::condition_variable alarm;
 
     public:
         /**
          * Constructor.
          */
-        MultiQueueProcessor() : running(true), thread(std::bind(&MultiQueueProcessor::onthread, std::ref(*this)))
+        MultiQueueProcessor() : MultiQueueProcessor(options_t())
         {
         }
 
+        /**
+         * Constructor.
+         * @param options [in] - Options of processor.
+         * @throw std::invalid_argument - The overflow is enabled without codec.
+         */
+        explicit MultiQueueProcessor(const options_t & options)
+            : options(validate(options)), running(true),
+              workers(this->options.minimum, maximum(this->options), this->options.backlog, this->options.latency, this->options.idle),
+              isolation(0, std::max<size_t>(1, this->options.isolation), 0, this->options.latency, this->options.idle),
+              slots(2 * maximum(this->options)), inflights(new inflight[this->slots])
+        {
+            if (this->options.budget.count() != 0) { this->watchdog = std::thread(&MultiQueueProcessor::onwatch, this); }
+        }
+
         /**
          * Destructor.
          * @throw None.
@@ -74,8 +327,7 @@ namespace multiqueue
         ~MultiQueueProcessor() noexcept
         {
             this->StopProcessing();
-
-            if (this->thread.joinable() != false) { this->thread.join(); }
+            this->Wait();
         }
 
         /**
@@ -83,31 +335,102 @@ namespace multiqueue
          */
         auto StopProcessing() -> void
         {
-            this->running = false;
+            {
+                mutex_guard_t sync(this->guard);
+
+                this->running = false;
+                this->alarm.notify_all();
+            }
+            this->workers.stop();
+            this->isolation.stop();
+#ifdef MULTIQUEUE_COROUTINES
+            // Coroutines, which wait by Next, are not resumed by dispatching threads anymore.
+            for (auto & key : this->queues.keys()) { this->cancel(this->queues.find(key)); }
+#endif // MULTIQUEUE_COROUTINES
         }
 
         /**
-         * Adds a new subscriber to proceed.
-         * @param key [in] - A unique key of subscriber.
+         * Adds a new subscriber to proceed, unless the key has one.
+         * @param key [in] - A unique key of subscriber, or a value, which is comparable with keys.
          * @param consumer [in] - A consumer.
          */
-        auto Subscribe(const Key & key, IConsumer<Key, Value> * consumer) -> void
+        template<typename K = Key>
+        auto Subscribe(const K & key, IConsumer<Key, Value> * consumer) -> void
         {
             assert(consumer != nullptr);
 
-            if (this->consumers.contains(key) != true && consumer != nullptr)
+            if (consumer == nullptr) { return; }
+
+            auto & object = this->channel_of(key);
+
+            if (attached(object) != true && object->consumer.attach(consumer) != false)
             {
-                this->consumers.insert({key, consumer});
+                // Dispatching messages, which have been added before.
+                this->schedule(object);
             }
         }
+#ifdef MULTIQUEUE_COROUTINES
+        /**
+         * Adds a new asynchronous subscriber to proceed, unless the key has one.
+         * Its tasks must complete before the processor is destroyed.
+         * @param key [in] - A unique key of subscriber, or a value, which is comparable with keys.
+         * @param consumer [in] - A consumer.
+         */
+        template<typename K = Key>
+        auto Subscribe(const K & key, IAsyncConsumer<Key, Value> * consumer) -> void
+        {
+            assert(consumer != nullptr);
+
+            if (consumer == nullptr) { return; }
+
+            auto & object = this->channel_of(key);
+
+            if (attached(object) != true && object->asynchronous.attach(consumer) != false)
+            {
+                this->schedule(object);
+            }
+        }
+#endif // MULTIQUEUE_COROUTINES
 
         /**
-         * Removes to support of subscriber.
-         * @param key [in] - A key of subscriber.
+         * Removes to support of subscriber. It returns, when the consumer is not called anymore,
+         * unless it is called from Consume of the same key. An asynchronous consumer is not called anymore,
+         * when its task completes. Calling Unsubscribe of a key from the task of its asynchronous consumer
+         * after the task has suspended deadlocks, since Unsubscribe waits for the task, which waits for Unsubscribe.
+         * Unsubscribe also blocks, while the task waits by Next for a message, which never comes,
+         * until StopProcessing resumes the task with an error.
+         * @param key [in] - A key of subscriber, or a value, which is comparable with keys.
          */
-        void Unsubscribe(const Key & key)
+        template<typename K = Key>
+        void Unsubscribe(const K & key)
         {
-            this->consumers.erase(key);
+            if (this->queues.contains(key) != true) { return; }
+
+            auto & object = this->queues.find(key);
+
+            object->consumer.detach();
+#ifdef MULTIQUEUE_COROUTINES
+            object->asynchronous.detach();
+#endif // MULTIQUEUE_COROUTINES
+            // Waiting for Consume to return, unless the consumer unsubscribes itself.
+            if (dispatching() != object.get())
+            {
+                object->consumer.quiesce();
+#ifdef MULTIQUEUE_COROUTINES
+                object->asynchronous.quiesce();
+#endif // MULTIQUEUE_COROUTINES
+            }
+        }
+
+        /**
+         * Interns a key, so its messages are added and read without lookups of key.
+         * @param key [in] - A key, or a value, which is comparable with keys.
+         * @return A handle of key.
+         */
+        template<typename K = Key>
+        auto Intern(const K & key) -> Handle
+        {
+            return Handle(this->channel_of(key));
         }
 
         /**
@@ -115,110 +438,608 @@ namespace multiqueue
          * @param id
          * @param value
          */
-        void Enqueue(const Key & key, Value value)
+        template<typename K = Key>
+        void Enqueue(const K & key, Value value)
         {
-            try
-            {
-                auto & queue = this->queues.find(key);
-                // Adding a new message into queue.
-                queue.enqueue(std::move(value));
-            }
-            catch (const std::invalid_argument &)
-            {// No data found.
-                try
-                {
-                    deque_t que(MAXCAPACITY);
-                    // Adding the value.
-                    que.enqueue(std::move(value));
-                    // Adding a new message into queue.
-                    this->queues.insert({key, std::move(que)});
-                }
-                catch (const std::out_of_range & exc)
-                {
-                    std::clog << exc.what() << std::endl;
-                }
-            }
+            auto & object = this->channel_of(key);
+            // Adding a new message into queue.
+            object->queue.enqueue(std::move(value));
+            diagnostics::trace::instant(diagnostics::event::enqueue, object.get());
+
+            this->schedule(object);
+        }
+
+        /**
+         * Adds a new message for subscriber of interned key.
+         * @param handle [in] - A handle of key.
+         * @param value [in] - A message.
+         */
+        void Enqueue(const Handle & handle, Value value)
+        {
+            assert(handle);
+
+            handle.object->queue.enqueue(std::move(value));
+            diagnostics::trace::instant(diagnostics::event::enqueue, handle.object.get());
+
+            this->schedule(handle.object);
+        }
+
+#ifdef MULTIQUEUE_COROUTINES
+        /**
+         * Gets the next message of key, the awaiting coroutine is suspended without a thread, while the queue is empty,
+         * and is resumed on a dispatching thread. A key of Next has no subscriber, otherwise they share messages.
+         * @param key [in] - A key, or a value, which is comparable with keys.
+         * @return An awaitable of message.
+         */
+        template<typename K = Key>
+        auto Next(const K & key) -> Awaiter
+        {
+            return Awaiter(this->channel_of(key), &this->running);
+        }
+
+        /**
+         * Gets the next message of interned key.
+         * @param handle [in] - A handle of key.
+         * @return An awaitable of message.
+         */
+        auto Next(const Handle & handle) -> Awaiter
+        {
+            assert(handle);
+
+            return Awaiter(handle.object, &this->running);
         }
+#endif // MULTIQUEUE_COROUTINES
 
         /**
          * Gets the first message from the queue of subscriber.
-         * @param key [in] - A subscriber key or id.
+         * @param key [in] - A subscriber key or id, or a value, which is comparable with keys.
          * @return A message.
          * @throw std::invalid_argument - No one message found.
+         * @throw std::exception - The message of overflow cannot be decoded, it is dropped.
          */
-        auto Dequeue(const Key & key) -> Value
+        template<typename K = Key>
+        auto Dequeue(const K & key) -> Value
         {
             if (this->queues.empty() != true)
             {
-                auto & queue = this->queues.find(key);
+                auto & object = this->queues.find(key);
 
-                if (queue.empty() != true)
+                if (object->queue.empty() != true)
                 {
-                    return std::move(queue.dequeue());
+                    auto value = object->queue.dequeue();
+                    diagnostics::trace::instant(diagnostics::event::dequeue, object.get());
+
+                    return value;
                 }
             }
             throw (std::invalid_argument("No one message found"));
         }
 
         /**
-         * Waits for finishing a thread.
+         * Gets the first message from the queue of interned key.
+         * @param handle [in] - A handle of key.
+         * @return A message.
+         * @throw std::invalid_argument - No one message found.
+         * @throw std::exception - The message of overflow cannot be decoded, it is dropped.
+         */
+        auto Dequeue(const Handle & handle) -> Value
+        {
+            assert(handle);
+
+            try
+            {
+                auto value = handle.object->queue.dequeue();
+                diagnostics::trace::instant(diagnostics::event::dequeue, handle.object.get());
+
+                return value;
+            }
+            catch (const std::out_of_range &)
+            {
+                throw (std::invalid_argument("No one message found"));
+            }
+        }
+
+        /**
+         * Waits, while the processing is stopped and dispatching threads are finished.
          */
         auto Wait() -> void
         {
-           if (this->thread.joinable()) { this->thread.join(); }
+            this->workers.wait();
+            this->isolation.wait();
+
+            std::thread thread;
+            {
+                mutex_guard_t sync(this->guard);
+                // The watchdog is joined once, though Wait may be called again by the destructor.
+                thread.swap(this->watchdog);
+            }
+            if (thread.joinable() != false) { thread.join(); }
         }
 
+        /**
+         * Checks whether a consumer of key is dispatched on the isolation threads.
+         * @param key [in] - A key of consumer, or a value, which is comparable with keys.
+         * @return true, if the consumer exceeds the time budget, otherwise false.
+         */
+        template<typename K = Key>
+        auto Isolated(const K & key) -> bool
+        {
+            return this->queues.contains(key) != false && this->queues.find(key)->isolated != false;
+        }
+
+#ifdef MULTIQUEUE_STORAGE
+        /**
+         * Writes pending messages of all keys into a file, messages stay in the processor.
+         * Every queue is consistent, but queues are not consistent with each other while producers run.
+         * @param path [in] - A path of snapshot.
+         * @throw std::invalid_argument - No codec of keys or messages.
+         * @throw std::system_error - The file cannot be written.
+         */
+        auto Snapshot(const std::string & path) -> void
+        {
+            this->check();
+
+            typename storage::snapshot<Key, Value>::source_t objects;
+
+            for (auto & key : this->queues.keys())
+            {
+                objects.emplace_back(key, &this->queues.find(key)->queue);
+            }
+            const auto shards = this->options.shards != 0 ? this->options.shards : std::thread::hardware_concurrency();
+
+            storage::snapshot<Key, Value>::save(path, objects, *this->options.keys, *this->options.codec, shards);
+        }
+
+        /**
+         * Adds messages from a snapshot to the end of queues. Messages beyond the capacity go to the overflow,
+         * without the overflow all of them are kept in memory, the capacity is not enforced.
+         * @param path [in] - A path of snapshot.
+         * @throw std::invalid_argument - No codec of keys or messages.
+         * @throw std::system_error - The file cannot be read.
+         * @throw std::runtime_error - The file is corrupted.
+         */
+        auto Restore(const std::string & path) -> void
+        {
+            this->check();
+
+            storage::snapshot<Key, Value>::load(path, *this->options.keys, *this->options.codec, [this](Key && key, std::deque<Value> && messages) -> void {
+                auto & object = this->channel_of(key);
+
+                object->queue.append(std::move(messages));
+                this->schedule(object);
+            });
+        }
+#endif // MULTIQUEUE_STORAGE
+
         /**
          * Gets a count of messages in the queue.
-         * @param key [in] - A key of consumer.
+         * @param key [in] - A key of consumer, or a value, which is comparable with keys.
          * @return A count of messages.
          */
-        auto Size(const Key & key) -> size_t
+        template<typename K = Key>
+        auto Size(const K & key) -> size_t
         {
             if (this->queues.contains(key) != false)
             {
-                return this->queues.find(key).size();
+                return this->queues.find(key)->queue.size();
             }
             return 0;
         }
 
+        /**
+         * Gets a count of messages in the queue of interned key.
+         * @param handle [in] - A handle of key.
+         * @return A count of messages.
+         */
+        auto Size(const Handle & handle) -> size_t
+        {
+            assert(handle);
+
+            return handle.object->queue.size();
+        }
+
     protected:
-        //!< A thread function, which proceeds messages from queue.
-        auto onthread() -> void
+        //!< Checks options before the processing is started.
+        static auto validate(const options_t & options) -> const options_t &
         {
-            while (this->running != false)
+            if (options.overflow.empty() != true && options.codec == nullptr)
+            {
+                throw (std::invalid_argument("No codec of overflow messages."));
+            }
+#ifndef MULTIQUEUE_STORAGE
+            if (options.overflow.empty() != true) { throw (std::invalid_argument("No overflow on this platform.")); }
+#endif // MULTIQUEUE_STORAGE
+            if (options.minimum > maximum(options)) { throw (std::invalid_argument("Wrong bounds of dispatching threads.")); }
+
+            return options;
+        }
+
+        //!< Gets a max count of dispatching threads.
+        static auto maximum(const options_t & options) -> size_t
+        {
+            if (options.maximum != 0) { return options.maximum; }
+
+            return std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        //!< Checks codecs of snapshots.
+        auto check() const -> void
+        {
+            if (this->options.keys == nullptr || this->options.codec == nullptr)
+            {
+                throw (std::invalid_argument("No codec of snapshot keys or messages."));
+            }
+        }
+
+        //!< Creates a queue of key.
+        auto create() const -> deque_t
+        {
+#ifdef MULTIQUEUE_STORAGE
+            if (this->options.overflow.empty() != true)
+            {
+                return deque_t(this->options.capacity, std::make_shared<storage::spill<Value>>(
+                    this->options.codec, this->options.overflow, this->options.segment, this->options.spare));
+            }
+#endif // MULTIQUEUE_STORAGE
+            return deque_t(this->options.capacity);
+        }
+
+        //!< Gets a channel, which is dispatched by the current thread.
+        static auto dispatching() -> const channel * &
+        {
+            static thread_local const channel * object = nullptr;
+
+            return object;
+        }
+
+        //!< Gets a channel of key, a new one is added if there is no one, so the key is copied only once.
+        template<typename K>
+        auto channel_of(const K & key) -> channel_t &
+        {
+            try
+            {
+                return this->queues.find(key);
+            }
+            catch (const std::invalid_argument &)
+            {// No data found, adding a new queue, if another producer has not added it yet.
+                const Key object(key);
+
+                this->queues.insert({object, std::make_shared<channel>(object, this->create())});
+
+                return this->queues.find(key);
+            }
+        }
+
+        //!< Checks whether a key has a consumer.
+        static auto attached(const channel_t & object) -> bool
+        {
+#ifdef MULTIQUEUE_COROUTINES
+            if (object->asynchronous.attached() != false) { return true; }
+#endif // MULTIQUEUE_COROUTINES
+            return object->consumer.attached();
+        }
+
+        //!< Passes a key to dispatching threads, unless it is already passed or has no consumer.
+        auto schedule(const channel_t & object) -> void
+        {
+#ifdef MULTIQUEUE_COROUTINES
+            // Coroutines, which wait by Next, take messages first.
+            this->wake(object);
+#endif // MULTIQUEUE_COROUTINES
+            if (this->running != true || object->scheduled != false) { return; }
+
+            if (attached(object) != false && object->scheduled.exchange(true) != true)
             {
+                auto & threads = object->isolated != false ? this->isolation : this->workers;
+
+                threads.submit([this, object]() -> void { this->dispatch(object); });
+            }
+        }
+
+        //!< Tracks a time of Consume, and moves a consumer between dispatching threads, returns true if moved.
+        auto measure(const channel_t & object, const std::chrono::steady_clock::duration & elapsed, const bool & overrun = false) -> bool
+        {
+            const auto budget = std::chrono::duration_cast<std::chrono::nanoseconds>(this->options.budget).count();
+
+            if (budget == 0) { return false; }
+
+            const auto sample = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            const auto average = object->average.load();
+            // Only one thread dispatches a key, so the average is not changed concurrently.
+            object->average = average + (sample - average) / 8;
+
+            if (overrun != false)
+            {// The watchdog has already isolated the consumer, while Consume was running.
+                object->isolated = true;
+                return true;
+            }
+            if (object->isolated != true && sample > budget)
+            {// A stalled consumer leaves shared threads at once.
+                object->isolated = true;
+                return true;
+            }
+            if (object->isolated != false && object->average < budget / 2)
+            {// The consumer has recovered.
+                object->isolated = false;
+                return true;
+            }
+            return false;
+        }
+
+        //!< Forwards a batch of messages of key to its consumer, one thread at a time per key.
+        auto dispatch(const channel_t & object) -> void
+        {
+            dispatching() = object.get();
+            // Consume on shared threads is watched, so a stalled one does not hold a shared thread unnoticed.
+            auto watched = this->watch(object);
+
+            for (auto i = 0; i < DISPATCH_BATCH && this->running != false; ++i)
+            {
+                // The consumer is not removed, while the guard is kept.
+                auto consumer = object->consumer.acquire();
+#ifdef MULTIQUEUE_COROUTINES
+                auto asynchronous = consumer ? async_guard_t(nullptr, nullptr) : object->asynchronous.acquire();
+
+                if (!consumer && !asynchronous) { break; }
+#else
+                if (!consumer) { break; }
+#endif // MULTIQUEUE_COROUTINES
+
+                Value value;
+
                 try
                 {
-                    this->consumers.for_each([this](const typename consumers_t::value_type & consumer) -> void {
+                    // Getting a value.
+                    value = object->queue.dequeue();
+                }
+                catch (const std::out_of_range &)
+                {// No one message found.
+                    break;
+                }
+                catch (const std::exception & exc)
+                {// The overflow cannot be read, the key is left, so it is passed again below.
+                    std::cerr << "[ERROR] " << exc.what() << std::endl;
+                    break;
+                }
+                diagnostics::trace::instant(diagnostics::event::claim, object.get());
+
+                const auto start = std::chrono::steady_clock::now();
+
+                if (watched != nullptr) { watched->started = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count(); }
+#ifdef MULTIQUEUE_COROUTINES
+                if (asynchronous)
+                {
+                    if (this->launch(object, std::move(asynchronous), std::move(value)) != false)
+                    {// The task has suspended, its completion passes the key again.
+                        if (this->settle(watched) != false) { object->isolated = true; }
+
+                        this->unwatch(watched);
+                        dispatching() = nullptr;
+                        return;
+                    }
+                }
+                else
+#endif // MULTIQUEUE_COROUTINES
+                {
+                    try
+                    {
+                        // Forwarding the message.
+                        consumer->Consume(object->key, value);
+                    }
+                    catch (const std::exception & exc)
+                    {
+                        std::cerr << "[ERROR] " << exc.what() << std::endl;
+                    }
+                }
+                const auto overrun = this->settle(watched);
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                diagnostics::trace::complete(diagnostics::event::consume, object.get(), start, elapsed);
+
+                if (this->measure(object, elapsed, overrun) != false)
+                {// The consumer has been moved to other threads.
+                    break;
+                }
+            }
+            this->unwatch(watched);
+            dispatching() = nullptr;
+            object->scheduled = false;
+            // Messages, which are added during dispatching, are passed again.
+            if (object->queue.empty() != true) { this->schedule(object); }
+        }
+
+        //!< Takes a slot of running Consume, returns nullptr if the key is isolated, or there is no free slot.
+        auto watch(const channel_t & object) -> inflight *
+        {
+            if (this->options.budget.count() == 0 || object->isolated != false) { return nullptr; }
+
+            for (size_t i = 0; i < this->slots; ++i)
+            {
+                channel * expected = nullptr;
+
+                if (this->inflights[i].object.compare_exchange_strong(expected, object.get()) != true) { continue; }
+
+                if (this->taken++ == 0)
+                {// The watchdog is woken, only when the first slot is taken.
+                    mutex_guard_t sync(this->guard);
+
+                    this->alarm.notify_all();
+                }
+                return &this->inflights[i];
+            }
+            return nullptr;
+        }
+
+        //!< Gives back a slot of running Consume.
+        auto unwatch(inflight * watched) -> void
+        {
+            if (watched == nullptr) { return; }
+
+            watched->object = nullptr;
+            --this->taken;
+        }
+
+        //!< Marks Consume as finished, returns true if the watchdog has isolated the consumer meanwhile.
+        auto settle(inflight * watched) -> bool
+        {
+            if (watched == nullptr || watched->started.exchange(0) >= 0) { return false; }
+            // The replacement thread, which is added by the watchdog, retires after the idle time.
+            this->workers.unblock();
+
+            return true;
+        }
+
+        //!< A thread function, which isolates a consumer, while its Consume overruns the time budget.
+        auto onwatch() -> void
+        {
+            const auto budget = std::chrono::duration_cast<std::chrono::nanoseconds>(this->options.budget);
+
+            mutex_guard_t sync(this->guard);
+
+            while (this->running != false)
+            {
+                // An idle processor makes no wakeups.
+                this->alarm.wait(sync, [this]() { return this->running != true || this->taken != 0; });
+                this->alarm.wait_for(sync, budget / 2);
+
+                const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+                for (size_t i = 0; i < this->slots && this->running != false; ++i)
+                {
+                    auto & watched = this->inflights[i];
+                    // The channel is read first, since the slot is given back only after Consume is marked as finished.
+                    auto object = watched.object.load();
+                    auto started = watched.started.load();
+
+                    if (object == nullptr || started <= 0 || now - started <= budget.count()) { continue; }
+                    if (watched.object.load() != object) { continue; }
+                    // A thread replaces the stalled one beforehand, so the dispatching thread always finds it added.
+                    this->workers.block();
 
-                        if (this->queues.empty() != true)
+                    if (watched.started.compare_exchange_strong(started, -1) != false)
+                    {// Later messages of key go to the isolation threads, though Consume is still running.
+                        object->isolated = true;
+                    }
+                    else
+                    {// Consume has finished meanwhile.
+                        this->workers.unblock();
+                    }
+                }
+            }
+        }
+#ifdef MULTIQUEUE_COROUTINES
+        struct pending final
+        {
+            pending(async_guard_t && consumer, Value && value) : consumer(std::move(consumer)), value(std::move(value)), stage(0)
+            {
+            }
+            //!< Keeps a consumer, it is not removed until the task completes.
+            async_guard_t consumer;
+            //!< Keeps a message, it is referred by the task.
+            Value value;
+            //!< Keeps a stage of task: 0 - running, 1 - completed, 2 - suspended.
+            std::atomic_int stage;
+        };
+
+        //!< Starts a task of asynchronous consumer, returns true if the task has suspended.
+        auto launch(const channel_t & object, async_guard_t && consumer, Value && value) -> bool
+        {
+            auto state = std::make_shared<pending>(std::move(consumer), std::move(value));
+
+            try
+            {
+                auto task = state->consumer->Consume(object->key, state->value);
+
+                task.start([this, object, state](std::exception_ptr error) -> void {
+                    if (error != nullptr)
+                    {
+                        try
                         {
-                            auto async = std::async(std::launch::async, [this, &consumer]() {
-
-                                try
-                                {
-                                    // Getting a value.
-                                    auto value = this->Dequeue(consumer.first);
-                                    // Forwarding the message.
-                                    consumer.second->Consume(consumer.first, value);
-                                }
-                                catch (const std::invalid_argument &)
-                                {
-                                }
-                                catch (const std::exception & exc)
-                                {
-                                    std::cerr << "[ERROR] " << exc.what() << std::endl;
-                                }
-                            });
+                            std::rethrow_exception(error);
                         }
-                    });
+                        catch (const std::exception & exc)
+                        {
+                            std::cerr << "[ERROR] " << exc.what() << std::endl;
+                        }
+                    }
+                    // The dispatching thread has left the key, so the key is passed again.
+                    if (state->stage.exchange(1) == 2)
+                    {
+                        object->scheduled = false;
+                        this->schedule(object);
+                    }
+                });
+            }
+            catch (const std::exception & exc)
+            {
+                std::cerr << "[ERROR] " << exc.what() << std::endl;
+                return false;
+            }
+            return state->stage.exchange(2) != 1;
+        }
+
+        //!< Passes messages to coroutines, which wait for them by Next, they are resumed on dispatching threads.
+        auto wake(const channel_t & object) -> void
+        {
+            if (object->awaiting.load() == 0) { return; }
+
+            std::unique_lock<std::mutex> sync(object->lock);
+            // After the processing is stopped, messages stay in the queue, since waiters are resumed by StopProcessing.
+            if (this->running != true) { return; }
+
+            while (object->waiters.empty() != true && object->waiters.front()->take() != false)
+            {
+                object->ready.push_back(object->waiters.front());
+                object->waiters.pop_front();
+                --object->awaiting;
+
+                this->workers.submit([this, object]() -> void { this->resume(object); });
+            }
+        }
+
+        //!< Resumes the first coroutine, which has got a message, unless StopProcessing has resumed it.
+        static auto resume(const channel_t & object) -> void
+        {
+            std::unique_lock<std::mutex> sync(object->lock);
+
+            if (object->ready.empty() != false) { return; }
+
+            auto waiter = object->ready.front();
+            object->ready.pop_front();
+
+            sync.unlock();
+
+            waiter->handle.resume();
+        }
+
+        //!< Resumes coroutines of key after the processing is stopped: ones, which have got messages, get them, others get an error.
+        static auto cancel(const channel_t & object) -> void
+        {
+            std::unique_lock<std::mutex> sync(object->lock);
+            // Tasks of dispatching threads may be dropped by the stopped pool, so every waiter is resumed here.
+            while (object->ready.empty() != true || object->waiters.empty() != true)
+            {
+                Awaiter * waiter = nullptr;
+
+                if (object->ready.empty() != true)
+                {
+                    waiter = object->ready.front();
+                    object->ready.pop_front();
                 }
-                catch (const std::exception &)
+                else
                 {
+                    waiter = object->waiters.front();
+                    waiter->stopped = true;
+                    object->waiters.pop_front();
+                    --object->awaiting;
                 }
+                sync.unlock();
+                // The coroutine may wait by Next again, it is not parked then, since the processing is stopped.
+                waiter->handle.resume();
+
+                sync.lock();
             }
         }
+#endif // MULTIQUEUE_COROUTINES
     };
 //-------------------------------------------------------------------------//
 }; // namespace multiqueue
@@ -0,0 +1,508 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          SharedMultiQueueProcessor.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A processor, which keeps queues in a named shared memory
+*                  region, so producers and the consumer run in different
+*                  processes.
+* - Comments:      Keys and messages must be trivially copyable, keys are
+*                  compared and hashed bytewise, so they must have no padding.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __SHAREDMULTIQUEUEPROCESSOR_H_A54F1D86_0C3B_4E97_92D8_6B1E7F3A0C25__
+#define __SHAREDMULTIQUEUEPROCESSOR_H_A54F1D86_0C3B_4E97_92D8_6B1E7F3A0C25__
+//-------------------------------------------------------------------------//
+#include <new>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <stdexcept>
+#include <type_traits>
+//-------------------------------------------------------------------------//
+#include <signal.h>
+#include <unistd.h>
+//-------------------------------------------------------------------------//
+#include "MultiQueueProcessor.h"
+#include "interprocess-region.h"
+//-------------------------------------------------------------------------//
+#define SHARED_MAGIC 0x5148534Du
+#define SHARED_VERSION 2u
+#define SHARED_KEYS 256
+#define SHARED_DEPTH 1024
+#define SHARED_BATCH 64
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    template<typename Key, typename Value>
+    class SharedMultiQueueProcessor final
+    {
+        static_assert(std::is_trivially_copyable<Key>::value, "Shared keys must be trivially copyable.");
+        static_assert(std::is_trivially_copyable<Value>::value, "Shared messages must be trivially copyable.");
+
+        using ring_t = interprocess::ring<Value>;
+        using consumer_t = std::atomic<IConsumer<Key, Value> *>;
+
+        //!< States of key entry.
+        enum : uint32_t { vacant = 0, writing = 1, occupied = 2 };
+
+        struct control
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t keys;
+            uint32_t depth;
+            uint32_t key;
+            uint32_t value;
+            //!< Keeps SHARED_MAGIC, when the region is initialized.
+            std::atomic<uint32_t> initialized;
+            //!< Keeps a counter of enqueued messages, the consumer sleeps on it.
+            alignas(64) std::atomic<uint32_t> signal;
+            //!< Keeps a flag of sleeping consumer.
+            std::atomic<uint32_t> sleeping;
+            //!< Keeps a counter of dequeued messages, blocked producers sleep on it.
+            alignas(64) std::atomic<uint32_t> space;
+            //!< Keeps a count of blocked producers.
+            std::atomic<uint32_t> blocked;
+        };
+
+        struct entry
+        {
+            std::atomic<uint32_t> state;
+            //!< Keeps an owner of consumer (a process id and an instance), 0 - no consumer.
+            std::atomic<uint64_t> owner;
+            Key key;
+        };
+
+    protected:
+        //!< Keeps a count of keys (a power of 2).
+        const size_t keys;
+        //!< Keeps a count of messages per key (a power of 2).
+        const size_t depth;
+        //!< Keeps a shared region.
+        interprocess::region region;
+        //!< Keeps a header of region.
+        control * header = nullptr;
+        //!< Keeps a table of keys.
+        entry * entries = nullptr;
+        //!< Keeps a memory of rings.
+        char * rings = nullptr;
+        //!< Keeps a list of consumers of the current process by index of key.
+        std::unique_ptr<consumer_t[]> consumers;
+        //!< Keeps an owner of consumers of this instance.
+        const uint64_t identity;
+        //!< Keeps an index of key, which is dispatched, keys - no one.
+        std::atomic<size_t> current;
+        //!< Keeps a flag of stopped or not.
+        std::atomic_bool running;
+        //!< Keeps a dispatching thread, it is started by the first subscriber.
+        std::thread thread;
+        //!< Keeps an identifier of dispatching thread, it is read without the lock.
+        std::atomic<std::thread::id> dispatcher;
+        std::mutex lock;
+
+    public:
+        /**
+         * Constructor. Creates a region or opens an existing one.
+         * @param name [in] - A name of region, it must be the same in all processes.
+         * @param keys [in] - A max count of keys, a power of 2.
+         * @param depth [in] - A max count of messages per key, a power of 2.
+         * @throw std::invalid_argument - Sizes are not powers of 2 or mismatch the existing region.
+         * @throw std::system_error - The region cannot be created or opened.
+         */
+        explicit SharedMultiQueueProcessor(const std::string & name, const size_t & keys = SHARED_KEYS, const size_t & depth = SHARED_DEPTH)
+            : keys(validate(keys)), depth(validate(depth)), region(name, footprint(keys, depth)),
+              consumers(new consumer_t[keys]), identity(instance()), current(keys), running(true)
+        {
+            auto memory = static_cast<char *>(this->region.memory());
+
+            this->header = reinterpret_cast<control *>(memory);
+            this->entries = reinterpret_cast<entry *>(memory + offset());
+            this->rings = memory + offset() + table(keys);
+
+            for (size_t i = 0; i < keys; ++i) { this->consumers[i] = nullptr; }
+
+            if (this->region.owner() != false)
+            {
+                this->initialize();
+            }
+            else
+            {
+                this->attach();
+            }
+        }
+
+        /**
+         * Destructor.
+         * @throw None.
+         */
+        ~SharedMultiQueueProcessor() noexcept
+        {
+            this->StopProcessing();
+
+            if (this->thread.joinable() != false) { this->thread.join(); }
+            // Other processes may subscribe to keys of this one.
+            for (size_t index = 0; index < this->keys; ++index)
+            {
+                if (this->consumers[index].load() != nullptr) { this->release(index); }
+            }
+        }
+
+        /**
+         * Removes a region from the system, processes keep their mappings.
+         * @param name [in] - A name of region.
+         */
+        static auto Remove(const std::string & name) -> void
+        {
+            interprocess::region::remove(name);
+        }
+
+        /**
+         * Stops to proceed message.
+         */
+        auto StopProcessing() -> void
+        {
+            this->running = false;
+            interprocess::wake(this->header->signal);
+        }
+
+        /**
+         * Adds a new subscriber of the current process and starts dispatching, unless the key has one.
+         * Only one processor may subscribe to a key, a key of finished process is taken over.
+         * @param key [in] - A unique key of subscriber.
+         * @param consumer [in] - A consumer.
+         * @throw std::length_error - No free key found.
+         * @throw std::logic_error - Another processor consumes the key.
+         */
+        auto Subscribe(const Key & key, IConsumer<Key, Value> * consumer) -> void
+        {
+            assert(consumer != nullptr);
+
+            if (consumer == nullptr) { return; }
+
+            const auto index = this->locate(key, true);
+
+            if (this->acquire(index) != true) { throw (std::logic_error("A key is consumed by another processor.")); }
+
+            IConsumer<Key, Value> * expected = nullptr;
+
+            this->consumers[index].compare_exchange_strong(expected, consumer);
+
+            std::unique_lock<std::mutex> sync(this->lock);
+
+            if (this->thread.joinable() != true && this->running != false)
+            {
+                this->thread = std::thread(&SharedMultiQueueProcessor::onthread, this);
+            }
+        }
+
+        /**
+         * Removes to support of subscriber, so another processor may subscribe to the key.
+         * @param key [in] - A key of subscriber.
+         */
+        auto Unsubscribe(const Key & key) -> void
+        {
+            const auto index = this->locate(key, false);
+
+            if (index >= this->keys || this->consumers[index].exchange(nullptr) == nullptr) { return; }
+            // The ring is not read by this processor, when another one takes it.
+            if (std::this_thread::get_id() != this->dispatcher.load())
+            {
+                while (this->current.load() == index) { std::this_thread::yield(); }
+            }
+            this->release(index);
+        }
+
+        /**
+         * Adds a new message for subscriber, it waits while the queue is full.
+         * @param key [in] - A key of subscriber.
+         * @param value [in] - A message.
+         * @throw std::length_error - No free key found.
+         */
+        auto Enqueue(const Key & key, const Value & value) -> void
+        {
+            auto queue = this->ring(this->locate(key, true));
+
+            while (queue.push(value) != true)
+            {
+                // Sleeping until the consumer makes space.
+                const auto space = this->header->space.load();
+                ++this->header->blocked;
+
+                if (queue.size() >= this->depth) { interprocess::wait(this->header->space, space, std::chrono::milliseconds(1)); }
+
+                --this->header->blocked;
+            }
+            ++this->header->signal;
+
+            if (this->header->sleeping.load() != 0) { interprocess::wake(this->header->signal, 1); }
+        }
+
+        /**
+         * Waits for finishing a thread.
+         */
+        auto Wait() -> void
+        {
+            if (this->thread.joinable()) { this->thread.join(); }
+        }
+
+        /**
+         * Gets a count of messages in the queue.
+         * @param key [in] - A key of consumer.
+         * @return A count of messages.
+         */
+        auto Size(const Key & key) -> size_t
+        {
+            const auto index = this->locate(key, false);
+
+            return index < this->keys ? this->ring(index).size() : 0;
+        }
+
+    protected:
+        //!< Checks a count is a power of 2.
+        static auto validate(const size_t & count) -> size_t
+        {
+            if (count == 0 || (count & (count - 1)) != 0) { throw (std::invalid_argument("A count must be a power of 2.")); }
+
+            return count;
+        }
+
+        //!< Gets an offset of the table of keys.
+        static constexpr auto offset() -> size_t
+        {
+            return (sizeof(control) + 63) / 64 * 64;
+        }
+
+        //!< Gets a size of the table of keys.
+        static constexpr auto table(const size_t & keys) -> size_t
+        {
+            return (keys * sizeof(entry) + 63) / 64 * 64;
+        }
+
+        //!< Gets a size of region.
+        static auto footprint(const size_t & keys, const size_t & depth) -> size_t
+        {
+            return offset() + table(keys) + keys * ring_t::footprint(depth);
+        }
+
+        //!< Gets a hash of key.
+        static auto hash(const Key & key) -> uint64_t
+        {
+            auto data = reinterpret_cast<const unsigned char *>(&key);
+            uint64_t value = 14695981039346656037ull;
+
+            for (size_t i = 0; i < sizeof(Key); ++i)
+            {
+                value = (value ^ data[i]) * 1099511628211ull;
+            }
+            return value;
+        }
+
+        //!< Gets a unique owner of consumers of this instance.
+        static auto instance() -> uint64_t
+        {
+            static std::atomic<uint32_t> counter(0);
+
+            return (static_cast<uint64_t>(::getpid()) << 32) | ++counter;
+        }
+
+        //!< Makes this instance an owner of key, an owner of finished process is replaced.
+        auto acquire(const size_t & index) -> bool
+        {
+            auto & owner = this->entries[index].owner;
+            auto expected = owner.load();
+
+            while (expected != this->identity)
+            {
+                const auto pid = static_cast<pid_t>(expected >> 32);
+
+                if (expected != 0 && (::kill(pid, 0) == 0 || errno != ESRCH)) { return false; }
+
+                if (owner.compare_exchange_strong(expected, this->identity) != false) { break; }
+            }
+            return true;
+        }
+
+        //!< Removes this instance from owners of key.
+        auto release(const size_t & index) -> void
+        {
+            auto expected = this->identity;
+
+            this->entries[index].owner.compare_exchange_strong(expected, 0);
+        }
+
+        //!< Gets a ring of key.
+        auto ring(const size_t & index) const -> ring_t
+        {
+            return ring_t(this->rings + index * ring_t::footprint(this->depth), this->depth);
+        }
+
+        //!< Initializes a new region.
+        auto initialize() -> void
+        {
+            auto object = new (this->header) control();
+
+            object->magic = SHARED_MAGIC;
+            object->version = SHARED_VERSION;
+            object->keys = static_cast<uint32_t>(this->keys);
+            object->depth = static_cast<uint32_t>(this->depth);
+            object->key = static_cast<uint32_t>(sizeof(Key));
+            object->value = static_cast<uint32_t>(sizeof(Value));
+            object->signal = object->sleeping = object->space = object->blocked = 0;
+
+            for (size_t i = 0; i < this->keys; ++i)
+            {
+                new (&this->entries[i].state) std::atomic<uint32_t>(vacant);
+                new (&this->entries[i].owner) std::atomic<uint64_t>(0);
+                this->ring(i).initialize();
+            }
+            object->initialized.store(SHARED_MAGIC, std::memory_order_release);
+        }
+
+        //!< Waits, while the creator initializes the region.
+        auto attach() -> void
+        {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(REGION_OPEN_TIMEOUT);
+
+            while (this->header->initialized.load(std::memory_order_acquire) != SHARED_MAGIC)
+            {
+                if (std::chrono::steady_clock::now() > deadline) { throw (std::runtime_error("Shared region is not initialized.")); }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (this->header->version != SHARED_VERSION || this->header->keys != this->keys || this->header->depth != this->depth ||
+                this->header->key != sizeof(Key) || this->header->value != sizeof(Value))
+            {
+                throw (std::invalid_argument("Mismatched layout of shared region."));
+            }
+        }
+
+        //!< Finds an index of key, a new key is added if insert is set, otherwise keys is returned if no key found.
+        auto locate(const Key & key, const bool & insert) -> size_t
+        {
+            const auto mask = this->keys - 1;
+            auto index = static_cast<size_t>(hash(key)) & mask;
+
+            for (size_t i = 0; i < this->keys; ++i, index = (index + 1) & mask)
+            {
+                auto & object = this->entries[index];
+                auto state = object.state.load(std::memory_order_acquire);
+
+                if (state == vacant)
+                {
+                    if (insert != true) { return this->keys; }
+
+                    uint32_t expected = vacant;
+
+                    if (object.state.compare_exchange_strong(expected, writing) != false)
+                    {
+                        std::memcpy(&object.key, &key, sizeof(Key));
+                        object.state.store(occupied, std::memory_order_release);
+
+                        return index;
+                    }
+                    state = expected;
+                }
+                // Another process is adding a key into the entry.
+                while (state == writing)
+                {
+                    std::this_thread::yield();
+                    state = object.state.load(std::memory_order_acquire);
+                }
+                if (std::memcmp(&object.key, &key, sizeof(Key)) == 0) { return index; }
+            }
+            if (insert != true) { return this->keys; }
+
+            throw (std::length_error("No free key found."));
+        }
+
+        //!< Proceeds messages of subscribers until one of them has some.
+        auto dispatch() -> bool
+        {
+            auto proceeded = false;
+
+            for (size_t index = 0; index < this->keys; ++index)
+            {
+                // Unsubscribe waits, while the key is dispatched.
+                this->current = index;
+
+                auto consumer = this->consumers[index].load();
+
+                if (consumer == nullptr) { continue; }
+
+                auto queue = this->ring(index);
+                Value value;
+
+                for (auto i = 0; i < SHARED_BATCH && queue.pop(value) != false; ++i)
+                {
+                    proceeded = true;
+
+                    try
+                    {
+                        consumer->Consume(this->entries[index].key, value);
+                    }
+                    catch (const std::exception & exc)
+                    {
+                        std::cerr << "[ERROR] " << exc.what() << std::endl;
+                    }
+                }
+            }
+            this->current = this->keys;
+
+            if (proceeded != false && this->header->blocked.load() != 0)
+            {
+                ++this->header->space;
+                interprocess::wake(this->header->space);
+            }
+            return proceeded;
+        }
+
+        //!< Checks whether subscribers have messages.
+        auto pending() const -> bool
+        {
+            for (size_t index = 0; index < this->keys; ++index)
+            {
+                if (this->consumers[index].load() != nullptr && this->ring(index).size() != 0) { return true; }
+            }
+            return false;
+        }
+
+        //!< A thread function, which proceeds messages from shared queues.
+        auto onthread() -> void
+        {
+            // It is set before any Consume, which may unsubscribe on this thread.
+            this->dispatcher = std::this_thread::get_id();
+
+            while (this->running != false)
+            {
+                if (this->dispatch() != false) { continue; }
+
+                // Sleeping until a producer adds a message.
+                this->header->sleeping = 1;
+                const auto signal = this->header->signal.load();
+
+                if (this->pending() != true && this->running != false)
+                {
+                    interprocess::wait(this->header->signal, signal, std::chrono::milliseconds(100));
+                }
+                this->header->sleeping = 0;
+            }
+        }
+    };
+//-------------------------------------------------------------------------//
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __SHAREDMULTIQUEUEPROCESSOR_H_A54F1D86_0C3B_4E97_92D8_6B1E7F3A0C25__
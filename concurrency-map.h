@@ -18,7 +18,9 @@
 #define __CONCURRENCY_CONSUMER_H_5460DAB4_02F0_4A8B_A618_A4046C88D84E__
 //-------------------------------------------------------------------------//
 #include <map>
+#include <vector>
 #include <mutex>
+#include <stdexcept>
 #include <functional>
 //-------------------------------------------------------------------------//
 namespace multiqueue
@@ -30,7 +32,8 @@ namespace multiqueue
         class map final
         {
             using mutex_lock_t = std::unique_lock<std::mutex>;
-            using objects_t = std::map<Key, Value>;
+            // Keys are compared transparently, so they are looked up by comparable types without copying.
+            using objects_t = std::map<Key, Value, std::less<>>;
             using iterator = typename objects_t::iterator;
             //!< Keeps a map of objects.
             objects_t objects;
@@ -38,7 +41,7 @@ namespace multiqueue
             mutable std::mutex lock;
 
         public:
-            using value_type = typename std::map<Key, Value>::value_type;
+            using value_type = typename objects_t::value_type;
 
         public:
             map(const map &) = delete;
@@ -117,10 +120,11 @@ namespace multiqueue
 
             /**
              *
-             * @param key
+             * @param key [in] - A key or a value, which is comparable with keys.
              * @return
              */
-            auto find(const Key & key) -> Value &
+            template<typename K = Key>
+            auto find(const K & key) -> Value &
             {
                 mutex_lock_t sync(this->lock);
 
@@ -133,26 +137,52 @@ namespace multiqueue
 
             /**
              *
-             * @param key
+             * @param key [in] - A key or a value, which is comparable with keys.
              * @return
              */
-            auto find(const Key & key) const -> const Value &
+            template<typename K = Key>
+            auto find(const K & key) const -> const Value &
             {
-                return this->find(key);
+                mutex_lock_t sync(this->lock);
+
+                auto iter = this->objects.find(key);
+
+                if (iter != this->objects.end()) { return (*iter).second; }
+
+                throw (std::invalid_argument("No one key found."));
             }
 
             /**
              *
-             * @param key
+             * @param key [in] - A key or a value, which is comparable with keys.
              * @return
              */
-            auto contains(const Key & key) const -> bool
+            template<typename K = Key>
+            auto contains(const K & key) const -> bool
             {
                 mutex_lock_t sync(this->lock);
 
                 return this->objects.find(key) != this->objects.end();
             }
 
+            /**
+             * Gets a list of keys.
+             * @return A list of keys.
+             */
+            auto keys() const -> std::vector<Key>
+            {
+                mutex_lock_t sync(this->lock);
+                std::vector<Key> objects;
+
+                objects.reserve(this->objects.size());
+
+                for (const auto & object : this->objects)
+                {
+                    objects.push_back(object.first);
+                }
+                return objects;
+            }
+
             /**
              *
              * @param callback
@@ -0,0 +1,320 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          concurrency-pool.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A pool of threads, which grows with a backlog of tasks and
+*                  shrinks after a period of idleness.
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __CONCURRENCY_POOL_H_B7E4A0D9_3C61_4F28_95DA_0E6C2B8F4173__
+#define __CONCURRENCY_POOL_H_B7E4A0D9_3C61_4F28_95DA_0E6C2B8F4173__
+//-------------------------------------------------------------------------//
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <iostream>
+#include <stdexcept>
+#include <functional>
+#include <condition_variable>
+//-------------------------------------------------------------------------//
+#include "diagnostics-trace.h"
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace concurrency
+    {
+//-------------------------------------------------------------------------//
+        class pool final
+        {
+            using mutex_guard_t = std::unique_lock<std::mutex>;
+            using clock_t = std::chrono::steady_clock;
+            using task_t = std::function<void()>;
+
+            struct item
+            {
+                //!< Keeps a task.
+                task_t task;
+                //!< Keeps a time of submitting.
+                clock_t::time_point time;
+            };
+            //!< Keeps a min count of threads.
+            const size_t minimum = 0;
+            //!< Keeps a max count of threads.
+            const size_t maximum = 1;
+            //!< Keeps a count of pending tasks, beyond which a thread is added.
+            const size_t backlog = 1;
+            //!< Keeps a waiting time of task, beyond which a thread is added.
+            const clock_t::duration latency;
+            //!< Keeps an idle time, after which a thread above the minimum retires.
+            const clock_t::duration idle;
+            //!< Keeps a list of pending tasks.
+            std::deque<item> tasks;
+            //!< Keeps a count of threads.
+            size_t workers = 0;
+            //!< Keeps a count of idle threads.
+            size_t waiting = 0;
+            //!< Keeps a count of threads blocked by their tasks, they are not counted against the max.
+            size_t blocked = 0;
+            //!< Keeps a flag of stopped or not.
+            bool stopped = false;
+            //!< Keeps a flag of running watcher of waiting tasks.
+            bool watching = false;
+            //!< Keeps a mutex.
+            mutable std::mutex lock;
+            std::condition_variable cond;
+            std::condition_variable finished;
+            std::condition_variable watch;
+
+        public:
+            pool(const pool &) = delete;
+            auto operator=(const pool &) -> pool & = delete;
+
+        public:
+            /**
+             * Constructor. Starts the min count of threads.
+             * @param minimum [in] - A min count of threads.
+             * @param maximum [in] - A max count of threads.
+             * @param backlog [in] - A count of pending tasks, beyond which a thread is added.
+             * @param latency [in] - A waiting time of task, beyond which a thread is added.
+             * @param idle [in] - An idle time, after which a thread above the minimum retires.
+             * @throw std::invalid_argument - Wrong bounds of threads.
+             */
+            pool(const size_t & minimum, const size_t & maximum, const size_t & backlog,
+                 const clock_t::duration & latency, const clock_t::duration & idle)
+                : minimum(minimum), maximum(maximum), backlog(backlog), latency(latency), idle(idle)
+            {
+                if (maximum == 0 || minimum > maximum) { throw (std::invalid_argument("Wrong bounds of pool threads.")); }
+
+                mutex_guard_t sync(this->lock);
+
+                while (this->workers < this->minimum) { this->spawn(); }
+            }
+
+            /**
+             * Destructor.
+             * @throw None.
+             */
+            ~pool() noexcept
+            {
+                this->stop();
+                this->wait();
+            }
+
+            /**
+             * Adds a new task, the task is dropped if the pool is stopped.
+             * @param task [in] - A task.
+             */
+            auto submit(task_t task) -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                if (this->stopped != false) { return; }
+
+                this->tasks.push_back({std::move(task), clock_t::now()});
+
+                if (this->waiting > 0) { this->cond.notify_one(); }
+                // Idle threads, which are notified but have not woken yet, are counted, so a burst is not left to them.
+                if (this->starved() != true) { return; }
+
+                if (this->workers < this->limit() && (this->workers == 0 || this->overloaded() != false))
+                {
+                    this->spawn();
+                }
+                else if (this->workers < this->limit() && this->watching != true)
+                {// Every thread is busy, the task is watched, since no submit may follow to check its latency.
+                    this->watching = true;
+                    std::thread(&pool::onwatch, this).detach();
+                }
+            }
+
+            /**
+             * Stops threads, pending tasks are dropped.
+             */
+            auto stop() -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                this->stopped = true;
+                this->tasks.clear();
+                this->cond.notify_all();
+                this->watch.notify_all();
+                // Waiters of a pool without threads are woken here.
+                this->finished.notify_all();
+            }
+
+            /**
+             * Waits, while the pool is stopped and all threads are finished.
+             */
+            auto wait() -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                this->finished.wait(sync, [this]() { return this->stopped != false && this->workers == 0 && this->watching != true; });
+            }
+
+            /**
+             * Tells that a thread is blocked by its task, a replacement thread is added.
+             */
+            auto block() -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                if (this->stopped != false) { return; }
+
+                ++this->blocked;
+
+                if (this->waiting == 0 && this->workers < this->limit()) { this->spawn(); }
+            }
+
+            /**
+             * Tells that a blocked thread goes on, extra threads retire after the idle time.
+             */
+            auto unblock() -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                if (this->blocked > 0) { --this->blocked; }
+            }
+
+            /**
+             * Gets a count of threads.
+             * @return A count of threads.
+             */
+            auto size() const -> size_t
+            {
+                mutex_guard_t sync(this->lock);
+
+                return this->workers;
+            }
+
+            /**
+             * Gets a count of pending tasks.
+             * @return A count of tasks.
+             */
+            auto pending() const -> size_t
+            {
+                mutex_guard_t sync(this->lock);
+
+                return this->tasks.size();
+            }
+
+        protected:
+            //!< Gets a max count of threads including replacements of blocked ones, it is called under the lock.
+            auto limit() const -> size_t
+            {
+                return this->maximum + this->blocked;
+            }
+
+            //!< Checks whether pending tasks outnumber idle threads, it is called under the lock.
+            auto starved() const -> bool
+            {
+                return this->tasks.size() > this->waiting;
+            }
+
+            //!< Checks whether pending tasks wait too long, it is called under the lock.
+            auto overloaded() const -> bool
+            {
+                if (this->tasks.size() > this->backlog * this->workers) { return true; }
+
+                return this->tasks.empty() != true && clock_t::now() - this->tasks.front().time >= this->latency;
+            }
+
+            //!< Starts a new thread, it is called under the lock.
+            auto spawn() -> void
+            {
+                std::thread(&pool::onthread, this).detach();
+                ++this->workers;
+            }
+
+            //!< A thread function, which adds threads, while tasks wait longer than the latency and every thread is busy.
+            auto onwatch() -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                while (this->stopped != true && this->starved() != false && this->workers < this->limit())
+                {
+                    const auto deadline = this->tasks.front().time + this->latency;
+
+                    if (clock_t::now() < deadline)
+                    {
+                        this->watch.wait_until(sync, deadline);
+                        continue;
+                    }
+                    this->spawn();
+                    // Giving the new thread a time to take the task.
+                    this->watch.wait_for(sync, this->latency);
+                }
+                this->watching = false;
+                this->finished.notify_all();
+            }
+
+            //!< A thread function, which runs tasks.
+            auto onthread() -> void
+            {
+                mutex_guard_t sync(this->lock);
+
+                while (this->stopped != true)
+                {
+                    if (this->tasks.empty() != true)
+                    {
+                        auto task = std::move(this->tasks.front().task);
+                        const auto time = this->tasks.front().time;
+                        this->tasks.pop_front();
+                        // Other threads are busy, while tasks keep waiting.
+                        if (this->starved() != false && this->workers < this->limit() && this->overloaded() != false) { this->spawn(); }
+
+                        sync.unlock();
+
+                        const auto traced = diagnostics::trace::enabled();
+                        const auto start = traced != false ? clock_t::now() : time;
+
+                        try
+                        {
+                            task();
+                        }
+                        catch (const std::exception & exc)
+                        {
+                            std::cerr << "[ERROR] " << exc.what() << std::endl;
+                        }
+                        if (traced != false) { diagnostics::trace::complete(diagnostics::event::task, this, start, clock_t::now() - start, start - time); }
+
+                        sync.lock();
+                        continue;
+                    }
+                    ++this->waiting;
+
+                    if (this->workers > this->minimum)
+                    {
+                        auto status = this->cond.wait_for(sync, this->idle);
+
+                        if (status == std::cv_status::timeout && this->tasks.empty() != false && this->workers > this->minimum)
+                        {// Retiring after a period of idleness.
+                            --this->waiting;
+                            break;
+                        }
+                    }
+                    else
+                    {// Threads of the minimum sleep without timeouts.
+                        this->cond.wait(sync);
+                    }
+                    --this->waiting;
+                }
+                --this->workers;
+                this->finished.notify_all();
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace concurrency
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __CONCURRENCY_POOL_H_B7E4A0D9_3C61_4F28_95DA_0E6C2B8F4173__
@@ -21,6 +21,13 @@
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+//-------------------------------------------------------------------------//
+#include "storage-overflow.h"
+#include "storage-ring.h"
 //-------------------------------------------------------------------------//
 namespace multiqueue
 {
@@ -31,13 +38,16 @@ namespace multiqueue
         class queue final
         {
             using mutex_guard_t = std::unique_lock<std::mutex>;
+            using overflow_t = std::shared_ptr<storage::overflow<TMessage>>;
             //!< Keeps a queue capacity.
             const size_t capacity = 0;
-            //!< Keeps a list of messages.
-            std::deque<TMessage> messages;
+            //!< Keeps a list of messages in contiguous slots.
+            storage::ring<TMessage> messages;
             //!< Keeps a mutex.
             mutable std::shared_ptr<std::mutex> lock;
             mutable std::shared_ptr<std::condition_variable> cond;
+            //!< Keeps an overflow tier of messages, which do not fit the capacity.
+            overflow_t overflow;
 
         public:
             /**
@@ -55,6 +65,16 @@ namespace multiqueue
             {
             }
 
+            /**
+             * Constructor.
+             * @param maxcount [in] - A max count of messages in memory.
+             * @param overflow [in] - An overflow tier, which keeps messages beyond the capacity.
+             */
+            queue(const size_t & maxcount, overflow_t overflow)
+                : capacity(maxcount), lock(new std::mutex()), cond(new std::condition_variable()), overflow(std::move(overflow))
+            {
+            }
+
             /**
              * Destructor.
              * @throw None.
@@ -66,10 +86,27 @@ namespace multiqueue
              * @param message [in] - A new message.
              */
             auto enqueue(const TMessage & message) -> void
+            {
+                this->enqueue(TMessage(message));
+            }
+
+            /**
+             * Adds a new message into queue.
+             * @param message [in] - A new message, it is moved into the queue.
+             */
+            auto enqueue(TMessage && message) -> void
             {
                 mutex_guard_t sync(*this->lock);
 
-                if (this->capacity > 0 && this->messages.size() >= this->capacity)
+                if (this->overflow != nullptr)
+                {
+                    if (this->overflow->empty() != true || (this->capacity > 0 && this->messages.size() >= this->capacity))
+                    {// Keeping the order, while the overflow has messages.
+                        this->overflow->push(message);
+                        return;
+                    }
+                }
+                else if (this->capacity > 0 && this->messages.size() >= this->capacity)
                 {
                     while (this->cond->wait_for(sync, std::chrono::microseconds(10)) != std::cv_status::timeout)
                     {
@@ -77,7 +114,49 @@ namespace multiqueue
                     //<???> throw (std::out_of_range("Too many messages in the queue [" + std::to_string(this->size()) + "]"));
                 }
                 // Adding a message into collection.
-                this->messages.push_back(message);
+                this->messages.push_back(std::move(message));
+            }
+
+            /**
+             * Adds a list of messages into queue at once. Messages beyond the capacity go to the overflow,
+             * without the overflow they are kept in memory, since nobody consumes them while they are added.
+             * @param objects [in] - A list of messages.
+             */
+            auto append(std::deque<TMessage> && objects) -> void
+            {
+                mutex_guard_t sync(*this->lock);
+
+                auto middle = objects.end();
+
+                if (this->overflow != nullptr)
+                {// Keeping the order, while the overflow has messages.
+                    auto room = this->overflow->empty() != true ? 0 : objects.size();
+
+                    if (this->capacity > 0) { room = std::min(room, this->capacity - std::min(this->capacity, this->messages.size())); }
+
+                    middle = objects.begin() + room;
+                }
+                this->messages.append(std::make_move_iterator(objects.begin()), std::make_move_iterator(middle));
+
+                for (auto iter = middle; iter != objects.end(); ++iter)
+                {
+                    this->overflow->push(*iter);
+                }
+            }
+
+            /**
+             * Calls a callback for every message in the queue in order without removing it.
+             * @param callback [in] - A callback.
+             */
+            auto for_each(const std::function<void(const TMessage & message)> & callback) const -> void
+            {
+                mutex_guard_t sync(*this->lock);
+
+                for (size_t i = 0; i < this->messages.size(); ++i)
+                {
+                    callback(this->messages[i]);
+                }
+                if (this->overflow != nullptr) { this->overflow->for_each(callback); }
             }
 
             /**
@@ -87,18 +166,23 @@ namespace multiqueue
              */
             auto dequeue() -> TMessage
             {
-                if (this->empty() != false) { throw (std::out_of_range("No one message found.")); }
+                mutex_guard_t sync(*this->lock);
 
-                TMessage object;
+                if (this->messages.empty() != true)
                 {
                     // Getting the first element.
-                    object = std::move(this->messages.front());
+                    TMessage object = std::move(this->messages.front());
                     // Removing the first element.
                     this->messages.pop_front();
                     //
                     this->cond->notify_one();
+
+                    return object;
                 }
-                return std::move(object);
+                // The memory is drained, reading the overflow.
+                if (this->overflow != nullptr && this->overflow->empty() != true) { return this->overflow->pop(); }
+
+                throw (std::out_of_range("No one message found."));
             }
 
             /**
@@ -109,7 +193,7 @@ namespace multiqueue
             {
                 mutex_guard_t sync(*this->lock);
 
-                return this->messages.empty();
+                return this->messages.empty() && (this->overflow == nullptr || this->overflow->empty());
             }
 
             /**
@@ -120,7 +204,7 @@ namespace multiqueue
             {
                 mutex_guard_t sync(*this->lock);
 
-                return this->messages.size();
+                return this->messages.size() + (this->overflow != nullptr ? this->overflow->size() : 0);
             }
         };
 //-------------------------------------------------------------------------//
@@ -0,0 +1,150 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          concurrency-slot.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A lock-free holder of object, which tracks readers, so
+*                  the object can be detached and waited to be idle.
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __CONCURRENCY_SLOT_H_2F6B9D04_E1A8_4C73_B5E2_8D40C7A19F36__
+#define __CONCURRENCY_SLOT_H_2F6B9D04_E1A8_4C73_B5E2_8D40C7A19F36__
+//-------------------------------------------------------------------------//
+#include <atomic>
+#include <thread>
+#include <chrono>
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace concurrency
+    {
+//-------------------------------------------------------------------------//
+        template<typename T>
+        class slot final
+        {
+            //!< Keeps an object.
+            std::atomic<T *> object;
+            //!< Keeps a count of readers, which may use the object.
+            std::atomic<size_t> readers;
+
+        public:
+            class guard final
+            {
+                //!< Keeps a slot, which is read.
+                slot * owner = nullptr;
+                //!< Keeps an object.
+                T * object = nullptr;
+
+            public:
+                guard(const guard &) = delete;
+                auto operator=(const guard &) -> guard & = delete;
+
+            public:
+                guard(slot * owner, T * object) : owner(owner), object(object)
+                {
+                }
+
+                guard(guard && other) noexcept : owner(other.owner), object(other.object)
+                {
+                    other.owner = nullptr;
+                    other.object = nullptr;
+                }
+
+                /**
+                 * Destructor. Releases the object.
+                 * @throw None.
+                 */
+                ~guard() noexcept
+                {
+                    if (this->owner != nullptr) { --this->owner->readers; }
+                }
+
+                auto operator->() const -> T * { return this->object; }
+
+                explicit operator bool() const { return this->object != nullptr; }
+            };
+
+        public:
+            slot(const slot &) = delete;
+            auto operator=(const slot &) -> slot & = delete;
+
+        public:
+            //!< Constructor.
+            slot() : object(nullptr), readers(0)
+            {
+            }
+
+            /**
+             * Sets an object, unless another one is set.
+             * @param value [in] - An object.
+             * @return true, if the object is set, otherwise false.
+             */
+            auto attach(T * value) -> bool
+            {
+                T * expected = nullptr;
+
+                return this->object.compare_exchange_strong(expected, value);
+            }
+
+            /**
+             * Removes an object, readers may still use it until quiesce returns.
+             * @return A removed object.
+             */
+            auto detach() -> T *
+            {
+                return this->object.exchange(nullptr);
+            }
+
+            /**
+             * Checks whether an object is set.
+             * @return true, if the object is set, otherwise false.
+             */
+            auto attached() const -> bool
+            {
+                return this->object.load() != nullptr;
+            }
+
+            /**
+             * Gets an object, which is not released until the guard is destroyed.
+             * @return A guard of object, which is empty if no object is set.
+             */
+            auto acquire() -> guard
+            {
+                // Readers are counted before the object is read, so a detached object is seen by quiesce.
+                ++this->readers;
+
+                auto value = this->object.load();
+
+                if (value == nullptr)
+                {
+                    --this->readers;
+                    return guard(nullptr, nullptr);
+                }
+                return guard(this, value);
+            }
+
+            /**
+             * Waits, while readers use an object.
+             */
+            auto quiesce() const -> void
+            {
+                for (auto i = 0; this->readers.load() != 0; ++i)
+                {
+                    if (i < 64) { std::this_thread::yield(); }
+                    else { std::this_thread::sleep_for(std::chrono::microseconds(100)); }
+                }
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace concurrency
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __CONCURRENCY_SLOT_H_2F6B9D04_E1A8_4C73_B5E2_8D40C7A19F36__
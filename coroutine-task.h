@@ -0,0 +1,173 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          coroutine-task.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A lazy coroutine, which is awaited by another coroutine
+*                  or started with a callback of completion.
+* - Comments:      It requires C++20 coroutines, MULTIQUEUE_COROUTINES is
+*                  defined when they are supported, and MULTIQUEUE_NO_COROUTINES
+*                  turns them off.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __COROUTINE_TASK_H_8D3E6B10_F47C_4A92_B1D5_39A0C7E28F64__
+#define __COROUTINE_TASK_H_8D3E6B10_F47C_4A92_B1D5_39A0C7E28F64__
+//-------------------------------------------------------------------------//
+#if defined(__cpp_impl_coroutine) && !defined(MULTIQUEUE_NO_COROUTINES)
+#define MULTIQUEUE_COROUTINES 1
+//-------------------------------------------------------------------------//
+#include <utility>
+#include <exception>
+#include <coroutine>
+#include <functional>
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace coroutine
+    {
+//-------------------------------------------------------------------------//
+        class task final
+        {
+        public:
+            using callback_t = std::function<void(std::exception_ptr error)>;
+
+            struct promise_type;
+            using handle_t = std::coroutine_handle<promise_type>;
+
+            struct final_awaiter
+            {
+                auto await_ready() const noexcept -> bool { return false; }
+
+                //!< Passes control to the awaiting coroutine, or frees a started task and calls its callback.
+                auto await_suspend(handle_t handle) noexcept -> std::coroutine_handle<>
+                {
+                    auto & promise = handle.promise();
+
+                    if (promise.continuation) { return promise.continuation; }
+
+                    auto callback = std::move(promise.callback);
+                    auto error = promise.error;
+
+                    handle.destroy();
+
+                    if (callback)
+                    {
+                        try
+                        {
+                            callback(error);
+                        }
+                        catch (...)
+                        {// A callback does not pass errors to a resumer.
+                        }
+                    }
+                    return std::noop_coroutine();
+                }
+
+                auto await_resume() const noexcept -> void {}
+            };
+
+            struct promise_type
+            {
+                //!< Keeps a callback of started task.
+                callback_t callback;
+                //!< Keeps a coroutine, which awaits the task.
+                std::coroutine_handle<> continuation;
+                //!< Keeps an error of task.
+                std::exception_ptr error;
+
+                auto get_return_object() -> task { return task(handle_t::from_promise(*this)); }
+
+                auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+                auto final_suspend() const noexcept -> final_awaiter { return {}; }
+
+                auto return_void() -> void {}
+
+                auto unhandled_exception() -> void { this->error = std::current_exception(); }
+            };
+
+            struct awaiter
+            {
+                //!< Keeps an awaited coroutine.
+                handle_t handle;
+
+                auto await_ready() const noexcept -> bool { return !this->handle || this->handle.done(); }
+
+                auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<>
+                {
+                    this->handle.promise().continuation = continuation;
+
+                    return this->handle;
+                }
+
+                auto await_resume() const -> void
+                {
+                    if (this->handle && this->handle.promise().error) { std::rethrow_exception(this->handle.promise().error); }
+                }
+            };
+
+        private:
+            //!< Keeps a coroutine, until it is started.
+            handle_t handle;
+
+            explicit task(handle_t handle) : handle(handle)
+            {
+            }
+
+        public:
+            task(const task &) = delete;
+            auto operator=(const task &) -> task & = delete;
+
+        public:
+            task(task && other) noexcept : handle(std::exchange(other.handle, nullptr))
+            {
+            }
+
+            auto operator=(task && other) noexcept -> task &
+            {
+                if (this != &other)
+                {
+                    if (this->handle) { this->handle.destroy(); }
+
+                    this->handle = std::exchange(other.handle, nullptr);
+                }
+                return *this;
+            }
+
+            /**
+             * Destructor. Frees a coroutine, which is not started.
+             * @throw None.
+             */
+            ~task() noexcept
+            {
+                if (this->handle) { this->handle.destroy(); }
+            }
+
+            /**
+             * Runs the task until it completes or suspends, then the task owns itself.
+             * @param callback [in] - A callback, which is called on the thread completing the task.
+             */
+            auto start(callback_t callback) -> void
+            {
+                auto handle = std::exchange(this->handle, nullptr);
+
+                handle.promise().callback = std::move(callback);
+                handle.resume();
+            }
+
+            auto operator co_await() && noexcept -> awaiter { return awaiter{this->handle}; }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace coroutine
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __cpp_impl_coroutine
+//-------------------------------------------------------------------------//
+#endif // __COROUTINE_TASK_H_8D3E6B10_F47C_4A92_B1D5_39A0C7E28F64__
@@ -0,0 +1,345 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          diagnostics-trace.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A timeline of dispatching, which is kept in per-thread
+*                  rings and written as Chrome trace events.
+* - Comments:      It is switched at runtime by trace::enable, and compiled
+*                  out by MULTIQUEUE_NO_TRACE.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __DIAGNOSTICS_TRACE_H_A27C5E19_0B4D_4F83_96E2_5D18C3F7B04A__
+#define __DIAGNOSTICS_TRACE_H_A27C5E19_0B4D_4F83_96E2_5D18C3F7B04A__
+//-------------------------------------------------------------------------//
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <system_error>
+//-------------------------------------------------------------------------//
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif // _WIN32
+//-------------------------------------------------------------------------//
+#define TRACE_BUFFER_SIZE 16384
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace diagnostics
+    {
+//-------------------------------------------------------------------------//
+        enum class event : uint32_t
+        {
+            //!< A message is added into the queue.
+            enqueue,
+            //!< A message is taken by Dequeue.
+            dequeue,
+            //!< A message is taken by a dispatching thread.
+            claim,
+            //!< A message is passed to Consume.
+            consume,
+            //!< A task runs on a thread of pool.
+            task
+        };
+//-------------------------------------------------------------------------//
+        class trace final
+        {
+            using mutex_guard_t = std::unique_lock<std::mutex>;
+            using clock_t = std::chrono::steady_clock;
+
+            struct slot
+            {
+                //!< Keeps a position of event plus one, 0 - the slot is being written.
+                std::atomic<uint64_t> sequence{0};
+                //!< Keeps a time of event in nanoseconds.
+                std::atomic<uint64_t> time{0};
+                //!< Keeps a duration of event in nanoseconds.
+                std::atomic<uint64_t> duration{0};
+                //!< Keeps an identifier of queue or pool.
+                std::atomic<uint64_t> id{0};
+                //!< Keeps a waiting time of task in nanoseconds.
+                std::atomic<uint64_t> value{0};
+                //!< Keeps a kind of event.
+                std::atomic<uint32_t> kind{0};
+            };
+
+            class buffer final
+            {
+            public:
+                //!< Keeps an index of buffer, it is a thread in the timeline.
+                const size_t lane;
+                //!< Keeps events, the oldest ones are overwritten.
+                std::unique_ptr<slot[]> slots;
+                //!< Keeps a mask of position, a count of slots is a power of two.
+                const uint64_t mask;
+                //!< Keeps a count of written events.
+                std::atomic<uint64_t> head{0};
+
+                buffer(const size_t & lane, const size_t & length) : lane(lane), slots(new slot[length]), mask(length - 1)
+                {
+                }
+
+                //!< Writes an event, it is called by the owner thread only.
+                auto push(const event & kind, const uint64_t & time, const uint64_t & duration, const uint64_t & id, const uint64_t & value) -> void
+                {
+                    const auto position = this->head.load(std::memory_order_relaxed);
+                    auto & object = this->slots[position & this->mask];
+
+                    object.sequence.store(0, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                    object.time.store(time, std::memory_order_relaxed);
+                    object.duration.store(duration, std::memory_order_relaxed);
+                    object.id.store(id, std::memory_order_relaxed);
+                    object.value.store(value, std::memory_order_relaxed);
+                    object.kind.store(static_cast<uint32_t>(kind), std::memory_order_relaxed);
+                    object.sequence.store(position + 1, std::memory_order_release);
+
+                    this->head.store(position + 1, std::memory_order_release);
+                }
+            };
+
+            struct registry
+            {
+                //!< Keeps a mutex.
+                std::mutex lock;
+                //!< Keeps all buffers, they are never freed.
+                std::vector<std::shared_ptr<buffer>> buffers;
+                //!< Keeps buffers of finished threads, they are reused by new threads.
+                std::vector<std::shared_ptr<buffer>> spare;
+                //!< Keeps a time, before which events are dropped.
+                std::atomic<uint64_t> cleared{0};
+                //!< Keeps a flag of tracing.
+                std::atomic_bool enabled{false};
+            };
+
+            struct owner
+            {
+                //!< Keeps a buffer of thread.
+                std::shared_ptr<buffer> object;
+
+                ~owner()
+                {
+                    if (this->object == nullptr) { return; }
+
+                    auto & objects = trace::objects();
+
+                    mutex_guard_t sync(objects.lock);
+
+                    objects.spare.push_back(std::move(this->object));
+                }
+            };
+
+        public:
+            /**
+             * Switches tracing on or off.
+             * @param value [in] - true, if events are recorded, otherwise false.
+             */
+            static auto enable(const bool & value) -> void
+            {
+                objects().enabled.store(value);
+            }
+
+            /**
+             * Checks whether tracing is on.
+             * @return true, if events are recorded, otherwise false.
+             */
+            static auto enabled() -> bool
+            {
+#ifdef MULTIQUEUE_NO_TRACE
+                return false;
+#else
+                return objects().enabled.load(std::memory_order_relaxed);
+#endif // MULTIQUEUE_NO_TRACE
+            }
+
+            /**
+             * Records an event, which has no duration.
+             * @param kind [in] - A kind of event.
+             * @param id [in] - An identifier of queue or pool.
+             */
+            static auto instant(const event & kind, const void * id) -> void
+            {
+                if (enabled() != false) { local().push(kind, now(clock_t::now()), 0, reinterpret_cast<uintptr_t>(id), 0); }
+            }
+
+            /**
+             * Records an event, which has a duration.
+             * @param kind [in] - A kind of event.
+             * @param id [in] - An identifier of queue or pool.
+             * @param start [in] - A start time of event.
+             * @param duration [in] - A duration of event.
+             * @param wait [in] - A waiting time before the event.
+             */
+            static auto complete(const event & kind, const void * id, const clock_t::time_point & start,
+                                 const clock_t::duration & duration, const clock_t::duration & wait = clock_t::duration::zero()) -> void
+            {
+                if (enabled() != false)
+                {
+                    local().push(kind, now(start), nanoseconds(duration), reinterpret_cast<uintptr_t>(id), nanoseconds(wait));
+                }
+            }
+
+            /**
+             * Drops events, which are recorded so far.
+             */
+            static auto clear() -> void
+            {
+                objects().cleared.store(now(clock_t::now()));
+            }
+
+            /**
+             * Writes events as Chrome trace events, it may be called while events are recorded.
+             * @param stream [out] - A stream.
+             */
+            static auto dump(std::ostream & stream) -> void
+            {
+                static const char * names[] = {"enqueue", "dequeue", "claim", "consume", "task"};
+
+                auto & objects = trace::objects();
+                const auto cleared = objects.cleared.load();
+#ifdef _WIN32
+                const auto pid = ::_getpid();
+#else
+                const auto pid = ::getpid();
+#endif // _WIN32
+                auto first = true;
+
+                mutex_guard_t sync(objects.lock);
+
+                stream << "{\"traceEvents\":[";
+
+                for (const auto & object : objects.buffers)
+                {
+                    stream << (first != false ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << object->lane
+                           << ",\"args\":{\"name\":\"thread " << object->lane << "\"}}";
+                    first = false;
+
+                    const auto head = object->head.load(std::memory_order_acquire);
+                    const auto length = object->mask + 1;
+
+                    for (auto position = head > length ? head - length : 0; position < head; ++position)
+                    {
+                        auto & item = object->slots[position & object->mask];
+
+                        const auto sequence = item.sequence.load(std::memory_order_acquire);
+                        const auto time = item.time.load(std::memory_order_relaxed);
+                        const auto duration = item.duration.load(std::memory_order_relaxed);
+                        const auto id = item.id.load(std::memory_order_relaxed);
+                        const auto value = item.value.load(std::memory_order_relaxed);
+                        const auto kind = item.kind.load(std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        // The event is skipped, if the owner has overwritten it while reading.
+                        if (sequence != position + 1 || item.sequence.load(std::memory_order_relaxed) != sequence) { continue; }
+                        if (time < cleared || kind >= sizeof(names) / sizeof(names[0])) { continue; }
+
+                        stream << ",{\"name\":\"" << names[kind] << "\",\"cat\":\"multiqueue\",\"pid\":" << pid << ",\"tid\":" << object->lane
+                               << ",\"ts\":" << microseconds(time);
+
+                        if (static_cast<event>(kind) == event::consume || static_cast<event>(kind) == event::task)
+                        {
+                            stream << ",\"ph\":\"X\",\"dur\":" << microseconds(duration);
+                        }
+                        else
+                        {
+                            stream << ",\"ph\":\"i\",\"s\":\"t\"";
+                        }
+                        stream << ",\"args\":{\"id\":\"0x" << std::hex << id << std::dec << "\"";
+
+                        if (static_cast<event>(kind) == event::task) { stream << ",\"wait\":" << microseconds(value); }
+
+                        stream << "}}";
+                    }
+                }
+                stream << "],\"displayTimeUnit\":\"ns\"}";
+            }
+
+            /**
+             * Writes events as Chrome trace events into a file.
+             * @param path [in] - A path of file.
+             * @throw std::system_error - The file cannot be written.
+             */
+            static auto dump(const std::string & path) -> void
+            {
+                std::ofstream stream(path, std::ios::out | std::ios::trunc);
+
+                if (stream.is_open() != true) { throw (std::system_error(errno, std::generic_category(), "Cannot open trace [" + path + "]")); }
+
+                dump(static_cast<std::ostream &>(stream));
+
+                if (stream.flush().good() != true) { throw (std::system_error(errno, std::generic_category(), "Cannot write trace [" + path + "]")); }
+            }
+
+        protected:
+            //!< Gets a registry of buffers, it is never destroyed, since threads may record events at exit.
+            static auto objects() -> registry &
+            {
+                static auto object = new registry();
+
+                return *object;
+            }
+
+            //!< Gets a buffer of the current thread, it is added on the first event.
+            static auto local() -> buffer &
+            {
+                static thread_local owner holder;
+
+                if (holder.object == nullptr)
+                {
+                    auto & objects = trace::objects();
+
+                    mutex_guard_t sync(objects.lock);
+
+                    if (objects.spare.empty() != true)
+                    {
+                        holder.object = std::move(objects.spare.back());
+                        objects.spare.pop_back();
+                    }
+                    else
+                    {
+                        holder.object = std::make_shared<buffer>(objects.buffers.size(), TRACE_BUFFER_SIZE);
+                        objects.buffers.push_back(holder.object);
+                    }
+                }
+                return *holder.object;
+            }
+
+            //!< Gets a time in nanoseconds.
+            static auto now(const clock_t::time_point & time) -> uint64_t
+            {
+                return nanoseconds(time.time_since_epoch());
+            }
+
+            static auto nanoseconds(const clock_t::duration & duration) -> uint64_t
+            {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+            }
+
+            //!< Gets a text of microseconds, which keeps nanoseconds.
+            static auto microseconds(const uint64_t & value) -> std::string
+            {
+                auto fraction = std::to_string(value % 1000);
+
+                return std::to_string(value / 1000) + "." + std::string(3 - fraction.size(), '0') + fraction;
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace diagnostics
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __DIAGNOSTICS_TRACE_H_A27C5E19_0B4D_4F83_96E2_5D18C3F7B04A__
@@ -0,0 +1,369 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          interprocess-region.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A named shared memory region, futex wakeups and a lock-free
+*                  ring, which are shared between processes.
+* - Comments:      Linux only.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __INTERPROCESS_REGION_H_3E91C7B2_58D4_4A6F_B0E3_71A2D9F54C18__
+#define __INTERPROCESS_REGION_H_3E91C7B2_58D4_4A6F_B0E3_71A2D9F54C18__
+//-------------------------------------------------------------------------//
+#include <new>
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+//-------------------------------------------------------------------------//
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+//-------------------------------------------------------------------------//
+#define REGION_OPEN_TIMEOUT 5000
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace interprocess
+    {
+        static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "Shared atomics must be lock-free.");
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "A futex word must be 32 bits.");
+//-------------------------------------------------------------------------//
+        /**
+         * Sleeps, while a shared word keeps an expected value.
+         * @param word [in] - A shared word.
+         * @param expected [in] - An expected value.
+         * @param timeout [in] - A max time of sleeping.
+         */
+        inline auto wait(std::atomic<uint32_t> & word, const uint32_t & expected, const std::chrono::nanoseconds & timeout) -> void
+        {
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            const struct timespec time = {static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &time, nullptr, 0);
+        }
+
+        /**
+         * Wakes processes, which sleep on a shared word.
+         * @param word [in] - A shared word.
+         * @param count [in] - A max count of woken processes.
+         */
+        inline auto wake(std::atomic<uint32_t> & word, const int & count = INT_MAX) -> void
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+        }
+//-------------------------------------------------------------------------//
+        class region final
+        {
+            //!< Keeps a name of region.
+            const std::string name;
+            //!< Keeps a file descriptor.
+            int fd = -1;
+            //!< Keeps a mapped memory.
+            void * data = nullptr;
+            //!< Keeps a size of region.
+            const size_t size = 0;
+            //!< Keeps a flag of created or opened.
+            bool created = false;
+
+        public:
+            region(const region &) = delete;
+            auto operator=(const region &) -> region & = delete;
+
+        public:
+            /**
+             * Constructor. Creates a zeroed region or opens an existing one.
+             * @param name [in] - A name of region.
+             * @param size [in] - A size of region.
+             * @throw std::system_error - The region cannot be created or mapped.
+             * @throw std::invalid_argument - The existing region has a different size.
+             */
+            region(const std::string & name, const size_t & size) : name(normalize(name)), size(size)
+            {
+                if ((this->fd = ::shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)) >= 0)
+                {
+                    this->created = true;
+
+                    if (::ftruncate(this->fd, static_cast<off_t>(this->size)) != 0)
+                    {
+                        auto error = errno;
+                        ::close(this->fd);
+                        ::shm_unlink(this->name.c_str());
+                        throw (std::system_error(error, std::generic_category(), "Cannot resize " + this->name));
+                    }
+                }
+                else if (errno == EEXIST && (this->fd = ::shm_open(this->name.c_str(), O_RDWR, 0600)) >= 0)
+                {
+                    this->attach();
+                }
+                else
+                {
+                    throw (std::system_error(errno, std::generic_category(), "Cannot open " + this->name));
+                }
+                auto memory = ::mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+
+                if (memory == MAP_FAILED)
+                {
+                    auto error = errno;
+                    ::close(this->fd);
+                    throw (std::system_error(error, std::generic_category(), "Cannot map " + this->name));
+                }
+                this->data = memory;
+            }
+
+            /**
+             * Destructor. The region stays in the system until it is removed.
+             * @throw None.
+             */
+            ~region() noexcept
+            {
+                ::munmap(this->data, this->size);
+                ::close(this->fd);
+            }
+
+            /**
+             * Removes a region from the system, processes keep their mappings.
+             * @param name [in] - A name of region.
+             */
+            static auto remove(const std::string & name) -> void
+            {
+                ::shm_unlink(normalize(name).c_str());
+            }
+
+            /**
+             * Gets a mapped memory.
+             * @return A mapped memory.
+             */
+            auto memory() const -> void *
+            {
+                return this->data;
+            }
+
+            /**
+             * Checks whether the region has been created by the current process.
+             * @return true, if the region is created, otherwise false.
+             */
+            auto owner() const -> bool
+            {
+                return this->created;
+            }
+
+        protected:
+            //!< Gets a name of region with the leading slash.
+            static auto normalize(const std::string & name) -> std::string
+            {
+                return (name.empty() != true && name[0] == '/') ? name : "/" + name;
+            }
+
+            //!< Waits, while the creator sets a size of region.
+            auto attach() -> void
+            {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(REGION_OPEN_TIMEOUT);
+
+                for (;;)
+                {
+                    struct stat info = {};
+
+                    if (::fstat(this->fd, &info) != 0)
+                    {
+                        auto error = errno;
+                        ::close(this->fd);
+                        throw (std::system_error(error, std::generic_category(), "Cannot stat " + this->name));
+                    }
+                    if (info.st_size != 0)
+                    {
+                        if (static_cast<size_t>(info.st_size) == this->size) { return; }
+
+                        ::close(this->fd);
+                        throw (std::invalid_argument("Mismatched size of " + this->name));
+                    }
+                    if (std::chrono::steady_clock::now() > deadline)
+                    {
+                        ::close(this->fd);
+                        throw (std::system_error(ETIMEDOUT, std::generic_category(), "Cannot attach " + this->name));
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        };
+//-------------------------------------------------------------------------//
+        template<typename TMessage>
+        class ring final
+        {
+            static_assert(std::is_trivially_copyable<TMessage>::value, "Shared messages must be trivially copyable.");
+
+            struct header
+            {
+                //!< Keeps a position of writing.
+                alignas(64) std::atomic<uint64_t> head;
+                //!< Keeps a position of reading.
+                alignas(64) std::atomic<uint64_t> tail;
+            };
+
+            struct slot
+            {
+                //!< Keeps a sequence, which tells whether the slot is free or written.
+                std::atomic<uint64_t> sequence;
+                //!< Keeps a message.
+                TMessage message;
+            };
+            //!< Keeps positions.
+            header * control = nullptr;
+            //!< Keeps a list of slots.
+            slot * slots = nullptr;
+            //!< Keeps a mask of position (a count of slots is a power of 2).
+            const uint64_t mask = 0;
+
+        public:
+            /**
+             * Gets a size of memory required by ring.
+             * @param depth [in] - A count of slots, a power of 2.
+             * @return A size of memory.
+             */
+            static constexpr auto footprint(const size_t & depth) -> size_t
+            {
+                return (sizeof(header) + depth * sizeof(slot) + 63) / 64 * 64;
+            }
+
+            /**
+             * Constructor. Makes a view of ring in shared memory.
+             * @param memory [in] - A memory of footprint(depth) bytes, aligned to 64.
+             * @param depth [in] - A count of slots, a power of 2.
+             */
+            ring(void * memory, const size_t & depth)
+                : control(static_cast<header *>(memory)), slots(reinterpret_cast<slot *>(static_cast<char *>(memory) + sizeof(header))), mask(depth - 1)
+            {
+            }
+
+            /**
+             * Initializes the ring, it is called once by the creator of memory.
+             */
+            auto initialize() -> void
+            {
+                new (this->control) header();
+                this->control->head.store(0, std::memory_order_relaxed);
+                this->control->tail.store(0, std::memory_order_relaxed);
+
+                for (uint64_t i = 0; i <= this->mask; ++i)
+                {
+                    new (&this->slots[i].sequence) std::atomic<uint64_t>(i);
+                }
+            }
+
+            /**
+             * Adds a message, it may be called by many producers.
+             * @param message [in] - A message.
+             * @return true, if the message is added, false if the ring is full.
+             */
+            auto push(const TMessage & message) -> bool
+            {
+                auto position = this->control->head.load(std::memory_order_relaxed);
+
+                for (;;)
+                {
+                    auto & object = this->slots[position & this->mask];
+                    const auto sequence = object.sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<int64_t>(sequence - position);
+
+                    if (diff == 0)
+                    {
+                        if (this->control->head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) != false)
+                        {
+                            std::memcpy(&object.message, &message, sizeof(TMessage));
+                            object.sequence.store(position + 1, std::memory_order_release);
+
+                            return true;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = this->control->head.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            /**
+             * Gets the first message, it may be called by one consumer only.
+             * @param message [out] - A message.
+             * @return true, if the message is got, false if the ring is empty.
+             */
+            auto pop(TMessage & message) -> bool
+            {
+                const auto position = this->control->tail.load(std::memory_order_relaxed);
+                auto & object = this->slots[position & this->mask];
+
+                if (object.sequence.load(std::memory_order_acquire) != position + 1) { return false; }
+
+                std::memcpy(&message, &object.message, sizeof(TMessage));
+                object.sequence.store(position + this->mask + 1, std::memory_order_release);
+                this->control->tail.store(position + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            /**
+             * Gets a count of messages in the ring.
+             * @return A count of messages.
+             */
+            auto size() const -> size_t
+            {
+                const auto tail = this->control->tail.load(std::memory_order_acquire);
+                const auto head = this->control->head.load(std::memory_order_acquire);
+
+                return head > tail ? static_cast<size_t>(head - tail) : 0;
+            }
+        };
+//-------------------------------------------------------------------------//
+        template<size_t Capacity>
+        struct bytes
+        {
+            //!< Keeps a count of used bytes.
+            uint32_t length = 0;
+            //!< Keeps a data.
+            char buffer[Capacity];
+
+            /**
+             * Copies a data into message.
+             * @param data [in] - A data.
+             * @param size [in] - A size of data.
+             * @throw std::length_error - The data does not fit the message.
+             */
+            auto assign(const void * data, const size_t & size) -> void
+            {
+                if (size > Capacity) { throw (std::length_error("Too large message [" + std::to_string(size) + "]")); }
+
+                std::memcpy(this->buffer, data, size);
+                this->length = static_cast<uint32_t>(size);
+            }
+
+            auto data() const -> const char * { return this->buffer; }
+
+            auto size() const -> size_t { return this->length; }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace interprocess
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __INTERPROCESS_REGION_H_3E91C7B2_58D4_4A6F_B0E3_71A2D9F54C18__
@@ -0,0 +1,58 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          storage-codec.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A codec of keys and messages, which are written to disk.
+* - Comments:      Methods of codec are called concurrently.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __STORAGE_CODEC_H_7A1F3C52_6B0E_4D8A_9E35_2C4F61B8D0A7__
+#define __STORAGE_CODEC_H_7A1F3C52_6B0E_4D8A_9E35_2C4F61B8D0A7__
+//-------------------------------------------------------------------------//
+#include <cstddef>
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    template<typename Value>
+    struct ICodec
+    {
+        using value_type = Value;
+
+        virtual ~ICodec() = default;
+
+        /**
+         * Gets a size of encoded value.
+         * @param value [in] - A value.
+         * @return A count of bytes required by Encode.
+         */
+        virtual auto Size(const Value & value) -> size_t = 0;
+
+        /**
+         * Encodes a value into buffer.
+         * @param value [in] - A value.
+         * @param buffer [out] - A buffer of at least Size(value) bytes.
+         */
+        virtual auto Encode(const Value & value, char * buffer) -> void = 0;
+
+        /**
+         * Decodes a value from buffer. If it throws while the overflow is read, the record is dropped,
+         * so a record, which cannot be decoded, does not block later messages of key. The error is logged
+         * by dispatching threads, and is passed to the caller of Dequeue.
+         * @param buffer [in] - A buffer.
+         * @param size [in] - A size of buffer.
+         * @return A value.
+         */
+        virtual auto Decode(const char * buffer, size_t size) -> Value = 0;
+    };
+//-------------------------------------------------------------------------//
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __STORAGE_CODEC_H_7A1F3C52_6B0E_4D8A_9E35_2C4F61B8D0A7__
@@ -0,0 +1,308 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          storage-message.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A byte message, which keeps small payloads inline and
+*                  large ones in pooled buffers.
+* - Comments:      A message of the default inline size fills one cache
+*                  line, so ring slots of messages do not share lines.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __STORAGE_MESSAGE_H_91D6B3E2_4A07_4C5F_8E19_D2B05F7A63C8__
+#define __STORAGE_MESSAGE_H_91D6B3E2_4A07_4C5F_8E19_D2B05F7A63C8__
+//-------------------------------------------------------------------------//
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+//-------------------------------------------------------------------------//
+#include "storage-codec.h"
+//-------------------------------------------------------------------------//
+#define MESSAGE_ALIGNMENT 64
+// The inline data and the count of bytes fill one line.
+#define MESSAGE_INLINE_SIZE (MESSAGE_ALIGNMENT - sizeof(uint32_t))
+#define MESSAGE_POOL_LIMIT (64 * 1024)
+#define MESSAGE_POOL_SPARE 256
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace storage
+    {
+//-------------------------------------------------------------------------//
+        class buffers final
+        {
+            using mutex_guard_t = std::unique_lock<std::mutex>;
+
+            struct bucket
+            {
+                //!< Keeps a mutex.
+                std::mutex lock;
+                //!< Keeps a list of free buffers.
+                std::vector<char *> spare;
+            };
+            //!< Keeps free buffers by powers of two up to the limit.
+            bucket buckets[64];
+
+        public:
+            buffers(const buffers &) = delete;
+            auto operator=(const buffers &) -> buffers & = delete;
+
+        public:
+            //!< Constructor.
+            buffers() = default;
+
+            /**
+             * Gets a pool, which is shared by messages of all sizes.
+             * @return A pool.
+             */
+            static auto instance() -> buffers &
+            {
+                // It is never destroyed, since static messages may be freed later.
+                static auto object = new buffers();
+
+                return *object;
+            }
+
+            /**
+             * Gets a buffer of at least the size, a free one is reused if any.
+             * @param size [in] - A size of buffer.
+             * @return A buffer.
+             */
+            auto acquire(const size_t & size) -> char *
+            {
+                if (size > MESSAGE_POOL_LIMIT) { return new char[size]; }
+
+                const auto index = log2(size);
+                auto & object = this->buckets[index];
+                {
+                    mutex_guard_t sync(object.lock);
+
+                    if (object.spare.empty() != true)
+                    {
+                        auto buffer = object.spare.back();
+                        object.spare.pop_back();
+                        return buffer;
+                    }
+                }
+                return new char[size_t(1) << index];
+            }
+
+            /**
+             * Gives back a buffer.
+             * @param buffer [in] - A buffer.
+             * @param size [in] - A size, which the buffer has been acquired with.
+             */
+            auto release(char * buffer, const size_t & size) -> void
+            {
+                if (size <= MESSAGE_POOL_LIMIT)
+                {
+                    auto & object = this->buckets[log2(size)];
+
+                    mutex_guard_t sync(object.lock);
+
+                    if (object.spare.size() < MESSAGE_POOL_SPARE)
+                    {
+                        object.spare.push_back(buffer);
+                        return;
+                    }
+                }
+                delete [] buffer;
+            }
+
+        protected:
+            //!< Gets a power of two, which is not less than the size.
+            static auto log2(const size_t & size) -> size_t
+            {
+                size_t index = 0;
+
+                while ((size_t(1) << index) < size) { ++index; }
+
+                return index;
+            }
+        };
+//-------------------------------------------------------------------------//
+        template<size_t Inline = MESSAGE_INLINE_SIZE>
+        class alignas(MESSAGE_ALIGNMENT) message final
+        {
+            static_assert(Inline >= sizeof(char *), "The inline size is less than a pointer.");
+            //!< Keeps a data, which is inline up to the inline size, or a pointer of pooled buffer.
+            char bytes[Inline];
+            //!< Keeps a count of bytes.
+            uint32_t length = 0;
+
+        public:
+            //!< Keeps a max size of inline data.
+            static constexpr size_t inline_size = Inline;
+
+        public:
+            //!< Constructor.
+            message()
+            {
+            }
+
+            /**
+             * Constructor.
+             * @param data [in] - A data.
+             * @param size [in] - A size of data.
+             */
+            message(const void * data, const size_t & size)
+            {
+                this->assign(data, size);
+            }
+
+            /**
+             * Constructor.
+             * @param data [in] - A data.
+             */
+            explicit message(const std::string_view & data) : message(data.data(), data.size())
+            {
+            }
+
+            message(const message & other) : message(other.data(), other.size())
+            {
+            }
+
+            message(message && other) noexcept
+            {
+                this->take(other);
+            }
+
+            /**
+             * Destructor.
+             * @throw None.
+             */
+            ~message() noexcept
+            {
+                this->release();
+            }
+
+            auto operator=(const message & other) -> message &
+            {
+                if (this != &other) { this->assign(other.data(), other.size()); }
+
+                return *this;
+            }
+
+            auto operator=(message && other) noexcept -> message &
+            {
+                if (this != &other)
+                {
+                    this->release();
+                    this->take(other);
+                }
+                return *this;
+            }
+
+            /**
+             * Copies a data into message, a large data is kept in a pooled buffer.
+             * @param data [in] - A data.
+             * @param size [in] - A size of data.
+             * @throw std::length_error - The data is larger than 4 GB.
+             */
+            auto assign(const void * data, const size_t & size) -> void
+            {
+                if (size > UINT32_MAX) { throw (std::length_error("Too large message.")); }
+                // The old buffer is freed after copying, since the data may be in it.
+                auto object = this->outline() != false ? this->buffer() : nullptr;
+                const size_t count = this->length;
+
+                if (size > Inline)
+                {
+                    auto target = buffers::instance().acquire(size);
+                    std::memcpy(target, data, size);
+                    std::memcpy(this->bytes, &target, sizeof(target));
+                }
+                else
+                {
+                    std::memmove(this->bytes, data, size);
+                }
+                this->length = static_cast<uint32_t>(size);
+
+                if (object != nullptr) { buffers::instance().release(object, count); }
+            }
+
+            auto data() const -> const char * { return this->outline() != false ? this->buffer() : this->bytes; }
+
+            auto size() const -> size_t { return this->length; }
+
+            /**
+             * Gets a view of data without copying.
+             * @return A view of data.
+             */
+            auto view() const -> std::string_view
+            {
+                return std::string_view(this->data(), this->length);
+            }
+
+            /**
+             * Checks whether a data is kept out of the message.
+             * @return true, if the data is in a pooled buffer, otherwise false.
+             */
+            auto outline() const -> bool
+            {
+                return this->length > Inline;
+            }
+
+        protected:
+            //!< Gets a pooled buffer, its pointer is kept in the inline bytes.
+            auto buffer() const -> char *
+            {
+                char * object = nullptr;
+
+                std::memcpy(&object, this->bytes, sizeof(object));
+
+                return object;
+            }
+
+            //!< Moves a data of other message, which is left empty, the line is copied as a whole.
+            auto take(message & other) -> void
+            {
+                std::memcpy(this->bytes, other.bytes, Inline);
+
+                this->length = other.length;
+                other.length = 0;
+            }
+
+            //!< Gives back a pooled buffer.
+            auto release() -> void
+            {
+                if (this->outline() != false) { buffers::instance().release(this->buffer(), this->length); }
+
+                this->length = 0;
+            }
+        };
+//-------------------------------------------------------------------------//
+        template<size_t Inline = MESSAGE_INLINE_SIZE>
+        class message_codec final : public ICodec<message<Inline>>
+        {
+        public:
+            virtual auto Size(const message<Inline> & value) -> size_t override
+            {
+                return value.size();
+            }
+
+            virtual auto Encode(const message<Inline> & value, char * buffer) -> void override
+            {
+                std::memcpy(buffer, value.data(), value.size());
+            }
+
+            virtual auto Decode(const char * buffer, size_t size) -> message<Inline> override
+            {
+                return message<Inline>(buffer, size);
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace storage
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __STORAGE_MESSAGE_H_91D6B3E2_4A07_4C5F_8E19_D2B05F7A63C8__
@@ -0,0 +1,70 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          storage-overflow.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   An interface of overflow tier of queue, which keeps
+*                  messages beyond the capacity.
+* - Comments:      The file-backed tier needs POSIX, it is compiled only
+*                  where MULTIQUEUE_STORAGE is defined.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __STORAGE_OVERFLOW_H_6D2F8B31_A4C7_4E95_B0D8_17E3C95A2F46__
+#define __STORAGE_OVERFLOW_H_6D2F8B31_A4C7_4E95_B0D8_17E3C95A2F46__
+//-------------------------------------------------------------------------//
+#include <cstddef>
+#include <functional>
+//-------------------------------------------------------------------------//
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(MULTIQUEUE_NO_STORAGE)
+#define MULTIQUEUE_STORAGE 1
+#endif // __unix__
+//-------------------------------------------------------------------------//
+#define SPILL_SEGMENT_SIZE (16 * 1024 * 1024)
+#define SPILL_SPARE_SEGMENTS 2
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace storage
+    {
+//-------------------------------------------------------------------------//
+        template<typename TMessage>
+        class overflow
+        {
+        public:
+            virtual ~overflow() = default;
+
+            /**
+             * Adds a message to the end.
+             * @param message [in] - A message.
+             */
+            virtual auto push(const TMessage & message) -> void = 0;
+
+            /**
+             * Gets the first message and removes it.
+             * @return The first message.
+             * @throw std::out_of_range - No one message found.
+             */
+            virtual auto pop() -> TMessage = 0;
+
+            /**
+             * Calls a callback for every message in order without removing it.
+             * @param callback [in] - A callback.
+             */
+            virtual auto for_each(const std::function<void(const TMessage & message)> & callback) const -> void = 0;
+
+            virtual auto empty() const -> bool = 0;
+
+            virtual auto size() const -> size_t = 0;
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace storage
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __STORAGE_OVERFLOW_H_6D2F8B31_A4C7_4E95_B0D8_17E3C95A2F46__
@@ -0,0 +1,146 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          storage-ring.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A circular buffer of messages in contiguous slots, which
+*                  grows and shrinks by powers of two.
+* - Comments:      It is not synchronized, the owner keeps a lock.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __STORAGE_RING_H_4C8E1A73_D25B_4F96_B0E7_6A3F92C1D8B4__
+#define __STORAGE_RING_H_4C8E1A73_D25B_4F96_B0E7_6A3F92C1D8B4__
+//-------------------------------------------------------------------------//
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+//-------------------------------------------------------------------------//
+#define RING_MIN_SLOTS 16
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace storage
+    {
+//-------------------------------------------------------------------------//
+        template<typename TMessage>
+        class ring final
+        {
+            //!< Keeps slots, a count of slots is a power of two.
+            std::vector<TMessage> slots;
+            //!< Keeps an index of the first message.
+            size_t head = 0;
+            //!< Keeps a count of messages.
+            size_t count = 0;
+
+        public:
+            //!< Constructor.
+            ring() = default;
+
+            /**
+             * Adds a message to the end.
+             * @param message [in] - A message.
+             */
+            auto push_back(TMessage && message) -> void
+            {
+                if (this->count == this->slots.size()) { this->resize(std::max<size_t>(RING_MIN_SLOTS, 2 * this->slots.size())); }
+
+                this->slots[(this->head + this->count) & (this->slots.size() - 1)] = std::move(message);
+                ++this->count;
+            }
+
+            /**
+             * Adds a message to the end.
+             * @param message [in] - A message.
+             */
+            auto push_back(const TMessage & message) -> void
+            {
+                this->push_back(TMessage(message));
+            }
+
+            /**
+             * Adds messages to the end at once, slots are grown once.
+             * @param begin [in] - The first message.
+             * @param end [in] - The end of messages.
+             */
+            template<typename Iterator>
+            auto append(Iterator begin, Iterator end) -> void
+            {
+                const auto length = this->count + static_cast<size_t>(std::distance(begin, end));
+
+                if (length > this->slots.size())
+                {
+                    auto size = std::max<size_t>(RING_MIN_SLOTS, this->slots.size());
+
+                    while (size < length) { size *= 2; }
+
+                    this->resize(size);
+                }
+                for (; begin != end; ++begin)
+                {
+                    this->slots[(this->head + this->count) & (this->slots.size() - 1)] = *begin;
+                    ++this->count;
+                }
+            }
+
+            /**
+             * Gets the first message.
+             * @return The first message.
+             */
+            auto front() -> TMessage &
+            {
+                return this->slots[this->head];
+            }
+
+            /**
+             * Removes the first message, its slot is reset, so resources of message are freed.
+             */
+            auto pop_front() -> void
+            {
+                this->slots[this->head] = TMessage();
+                this->head = (this->head + 1) & (this->slots.size() - 1);
+                --this->count;
+                // Giving back memory after a burst.
+                if (this->slots.size() > RING_MIN_SLOTS && this->count < this->slots.size() / 4) { this->resize(this->slots.size() / 2); }
+            }
+
+            /**
+             * Gets a message by its position from the first one.
+             * @param index [in] - A position of message.
+             * @return A message.
+             */
+            auto operator[](const size_t & index) const -> const TMessage &
+            {
+                return this->slots[(this->head + index) & (this->slots.size() - 1)];
+            }
+
+            auto empty() const -> bool { return this->count == 0; }
+
+            auto size() const -> size_t { return this->count; }
+
+        protected:
+            //!< Moves messages into new slots, the first message is placed at the beginning.
+            auto resize(const size_t & length) -> void
+            {
+                std::vector<TMessage> objects(length);
+
+                for (size_t i = 0; i < this->count; ++i)
+                {
+                    objects[i] = std::move(this->slots[(this->head + i) & (this->slots.size() - 1)]);
+                }
+                this->slots.swap(objects);
+                this->head = 0;
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace storage
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __STORAGE_RING_H_4C8E1A73_D25B_4F96_B0E7_6A3F92C1D8B4__
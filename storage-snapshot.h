@@ -0,0 +1,331 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          storage-snapshot.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   A binary snapshot of queued messages.
+* - Comments:      The file keeps a header, a table of shards and shards of
+*                  length-prefixed records in the native byte order:
+*                  [key size][key][message count]{[message size][message]}.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __STORAGE_SNAPSHOT_H_9D3E5B18_2A7C_4F40_86E1_B05C4D72A3F9__
+#define __STORAGE_SNAPSHOT_H_9D3E5B18_2A7C_4F40_86E1_B05C4D72A3F9__
+//-------------------------------------------------------------------------//
+#include <deque>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <stdexcept>
+#include <exception>
+#include <functional>
+#include <system_error>
+//-------------------------------------------------------------------------//
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+//-------------------------------------------------------------------------//
+#include "storage-codec.h"
+#include "concurrency-queue.h"
+//-------------------------------------------------------------------------//
+#define SNAPSHOT_MAGIC 0x4E534D51u
+#define SNAPSHOT_VERSION 1u
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace storage
+    {
+//-------------------------------------------------------------------------//
+        template<typename Key, typename Value>
+        class snapshot final
+        {
+            using buffer_t = std::vector<char>;
+
+            struct header
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t shards;
+                uint32_t reserved;
+            };
+
+            struct shard
+            {
+                uint64_t offset;
+                uint64_t size;
+            };
+
+        public:
+            using source_t = std::vector<std::pair<Key, const concurrency::queue<Value> *>>;
+            using sink_t = std::function<void(Key && key, std::deque<Value> && messages)>;
+
+        public:
+            /**
+             * Writes messages of queues into a file, one writer per shard.
+             * The file is replaced atomically, but it is not synced to disk.
+             * @param path [in] - A path of snapshot.
+             * @param queues [in] - A list of queues with keys.
+             * @param keys [in] - A codec of keys.
+             * @param values [in] - A codec of messages.
+             * @param shards [in] - A count of shards.
+             * @throw std::system_error - The file cannot be written.
+             */
+            static auto save(const std::string & path, const source_t & queues, ICodec<Key> & keys, ICodec<Value> & values, size_t shards) -> void
+            {
+                shards = std::max<size_t>(1, std::min(shards, queues.size()));
+
+                std::vector<buffer_t> buffers(shards);
+                // Encoding shards.
+                parallel(shards, [&](const size_t & index) -> void {
+
+                    auto & buffer = buffers[index];
+
+                    for (auto i = index; i < queues.size(); i += shards)
+                    {
+                        put(buffer, keys, queues[i].first);
+                        // The count is known after the queue is passed.
+                        const auto position = buffer.size();
+                        uint64_t count = 0;
+                        buffer.resize(position + sizeof(count));
+
+                        queues[i].second->for_each([&](const Value & message) -> void {
+                            put(buffer, values, message);
+                            ++count;
+                        });
+                        std::memcpy(buffer.data() + position, &count, sizeof(count));
+                    }
+                });
+                // Making a table of shards.
+                std::vector<shard> table(shards);
+                uint64_t offset = sizeof(header) + shards * sizeof(shard);
+
+                for (size_t i = 0; i < shards; ++i)
+                {
+                    table[i] = {offset, buffers[i].size()};
+                    offset += buffers[i].size();
+                }
+                const auto temporary = path + ".tmp";
+                const header head = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, static_cast<uint32_t>(shards), 0};
+
+                auto fd = ::open(temporary.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+
+                if (fd < 0) { throw (std::system_error(errno, std::generic_category(), "Cannot create " + temporary)); }
+
+                try
+                {
+                    write(fd, &head, sizeof(head), 0);
+                    write(fd, table.data(), table.size() * sizeof(shard), sizeof(head));
+                    // Writing shards.
+                    parallel(shards, [&](const size_t & index) -> void {
+                        write(fd, buffers[index].data(), buffers[index].size(), table[index].offset);
+                    });
+                }
+                catch (...)
+                {
+                    ::close(fd);
+                    ::unlink(temporary.c_str());
+                    throw;
+                }
+                ::close(fd);
+
+                if (::rename(temporary.c_str(), path.c_str()) != 0)
+                {
+                    auto error = errno;
+                    ::unlink(temporary.c_str());
+                    throw (std::system_error(error, std::generic_category(), "Cannot rename " + temporary));
+                }
+            }
+
+            /**
+             * Reads messages of queues from a file, one reader per shard.
+             * @param path [in] - A path of snapshot.
+             * @param keys [in] - A codec of keys.
+             * @param values [in] - A codec of messages.
+             * @param sink [in] - A callback, which gets messages of every key, it is called concurrently.
+             * @throw std::system_error - The file cannot be read.
+             * @throw std::runtime_error - The file is corrupted.
+             */
+            static auto load(const std::string & path, ICodec<Key> & keys, ICodec<Value> & values, const sink_t & sink) -> void
+            {
+                auto fd = ::open(path.c_str(), O_RDONLY);
+
+                if (fd < 0) { throw (std::system_error(errno, std::generic_category(), "Cannot open " + path)); }
+
+                struct stat info = {};
+
+                if (::fstat(fd, &info) != 0)
+                {
+                    auto error = errno;
+                    ::close(fd);
+                    throw (std::system_error(error, std::generic_category(), "Cannot stat " + path));
+                }
+                const auto size = static_cast<size_t>(info.st_size);
+
+                if (size < sizeof(header)) { ::close(fd); throw (std::runtime_error("Corrupted snapshot " + path)); }
+
+                auto memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                auto error = errno;
+                // The mapping keeps the file.
+                ::close(fd);
+
+                if (memory == MAP_FAILED) { throw (std::system_error(error, std::generic_category(), "Cannot map " + path)); }
+
+                const auto data = static_cast<const char *>(memory);
+
+                try
+                {
+                    ::madvise(memory, size, MADV_WILLNEED);
+
+                    header head = {};
+                    std::memcpy(&head, data, sizeof(head));
+
+                    if (head.magic != SNAPSHOT_MAGIC || head.version != SNAPSHOT_VERSION || head.shards == 0 ||
+                        sizeof(header) + head.shards * sizeof(shard) > size)
+                    {
+                        throw (std::runtime_error("Corrupted snapshot " + path));
+                    }
+                    std::vector<shard> table(head.shards);
+                    std::memcpy(table.data(), data + sizeof(header), table.size() * sizeof(shard));
+
+                    for (const auto & object : table)
+                    {
+                        if (object.offset > size || object.size > size - object.offset)
+                        {
+                            throw (std::runtime_error("Corrupted snapshot " + path));
+                        }
+                    }
+                    // Decoding shards.
+                    parallel(table.size(), [&](const size_t & index) -> void {
+
+                        const auto end = data + table[index].offset + table[index].size;
+
+                        for (auto begin = data + table[index].offset; begin != end;)
+                        {
+                            auto key = get(begin, end, keys);
+                            uint64_t count = 0;
+
+                            take(begin, end, &count, sizeof(count));
+
+                            std::deque<Value> messages;
+
+                            for (uint64_t i = 0; i < count; ++i)
+                            {
+                                messages.push_back(get(begin, end, values));
+                            }
+                            sink(std::move(key), std::move(messages));
+                        }
+                    });
+                }
+                catch (...)
+                {
+                    ::munmap(memory, size);
+                    throw;
+                }
+                ::munmap(memory, size);
+            }
+
+        protected:
+            //!< Runs a callback for every index in a separate thread and rethrows the first error.
+            static auto parallel(const size_t & count, const std::function<void(const size_t & index)> & callback) -> void
+            {
+                std::vector<std::exception_ptr> errors(count);
+                std::vector<std::thread> threads;
+
+                threads.reserve(count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    threads.emplace_back([&callback, &errors, i]() -> void {
+                        try
+                        {
+                            callback(i);
+                        }
+                        catch (...)
+                        {
+                            errors[i] = std::current_exception();
+                        }
+                    });
+                }
+                for (auto & thread : threads) { thread.join(); }
+
+                for (const auto & error : errors)
+                {
+                    if (error != nullptr) { std::rethrow_exception(error); }
+                }
+            }
+
+            //!< Writes a whole buffer at an offset of file.
+            static auto write(int fd, const void * buffer, size_t size, uint64_t offset) -> void
+            {
+                auto data = static_cast<const char *>(buffer);
+
+                while (size > 0)
+                {
+                    auto count = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+
+                    if (count < 0)
+                    {
+                        if (errno == EINTR) { continue; }
+
+                        throw (std::system_error(errno, std::generic_category(), "Cannot write a snapshot"));
+                    }
+                    data += count;
+                    size -= static_cast<size_t>(count);
+                    offset += static_cast<uint64_t>(count);
+                }
+            }
+
+            //!< Appends a length-prefixed record to buffer.
+            template<typename T>
+            static auto put(buffer_t & buffer, ICodec<T> & codec, const T & object) -> void
+            {
+                const auto length = static_cast<uint32_t>(codec.Size(object));
+                const auto position = buffer.size();
+
+                buffer.resize(position + sizeof(length) + length);
+                std::memcpy(buffer.data() + position, &length, sizeof(length));
+                codec.Encode(object, buffer.data() + position + sizeof(length));
+            }
+
+            //!< Reads a length-prefixed record.
+            template<typename T>
+            static auto get(const char * & begin, const char * end, ICodec<T> & codec) -> T
+            {
+                uint32_t length = 0;
+
+                take(begin, end, &length, sizeof(length));
+
+                if (static_cast<size_t>(end - begin) < length) { throw (std::runtime_error("Corrupted snapshot record")); }
+
+                auto object = codec.Decode(begin, length);
+                begin += length;
+
+                return object;
+            }
+
+            //!< Reads a fixed-size field.
+            static auto take(const char * & begin, const char * end, void * object, const size_t & size) -> void
+            {
+                if (static_cast<size_t>(end - begin) < size) { throw (std::runtime_error("Corrupted snapshot record")); }
+
+                std::memcpy(object, begin, size);
+                begin += size;
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace storage
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __STORAGE_SNAPSHOT_H_9D3E5B18_2A7C_4F40_86E1_B05C4D72A3F9__
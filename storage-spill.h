@@ -0,0 +1,388 @@
+/*!==========================================================================
+* \file
+* - Program:       multiqueue
+* - File:          storage-spill.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:   An overflow tier of queue, which appends messages into
+*                  memory-mapped segment files and reads them back in order.
+* - Comments:      Segment files are unlinked right after creation, so they
+*                  never outlive the process.
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __STORAGE_SPILL_H_E2B6D41F_93C7_4A05_B8D2_5F0A7C13E964__
+#define __STORAGE_SPILL_H_E2B6D41F_93C7_4A05_B8D2_5F0A7C13E964__
+//-------------------------------------------------------------------------//
+#include <deque>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <functional>
+#include <cerrno>
+//-------------------------------------------------------------------------//
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+//-------------------------------------------------------------------------//
+#include "storage-codec.h"
+#include "storage-overflow.h"
+//-------------------------------------------------------------------------//
+namespace multiqueue
+{
+    namespace storage
+    {
+//-------------------------------------------------------------------------//
+        class segment final
+        {
+            //!< Keeps a file descriptor.
+            int fd = -1;
+            //!< Keeps a mapped memory.
+            char * data = nullptr;
+            //!< Keeps a size of mapped memory.
+            const size_t capacity = 0;
+            //!< Keeps an offset of writing.
+            size_t written = 0;
+            //!< Keeps an offset of reading.
+            size_t read = 0;
+
+        public:
+            segment(const segment &) = delete;
+            auto operator=(const segment &) -> segment & = delete;
+
+        public:
+            /**
+             * Constructor.
+             * @param directory [in] - A directory of segment file.
+             * @param size [in] - A size of segment.
+             * @throw std::system_error - The segment file cannot be created or mapped.
+             */
+            segment(const std::string & directory, const size_t & size) : capacity(size)
+            {
+                auto path = directory + "/multiqueue-XXXXXX";
+
+                if ((this->fd = ::mkstemp(&path[0])) < 0)
+                {
+                    throw (std::system_error(errno, std::generic_category(), "Cannot create a segment in " + directory));
+                }
+                // The file lives as long as the descriptor is opened.
+                ::unlink(path.c_str());
+
+                if (::ftruncate(this->fd, static_cast<off_t>(this->capacity)) != 0)
+                {
+                    auto error = errno;
+                    ::close(this->fd);
+                    throw (std::system_error(error, std::generic_category(), "Cannot resize a segment"));
+                }
+                auto memory = ::mmap(nullptr, this->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+
+                if (memory == MAP_FAILED)
+                {
+                    auto error = errno;
+                    ::close(this->fd);
+                    throw (std::system_error(error, std::generic_category(), "Cannot map a segment"));
+                }
+                this->data = static_cast<char *>(memory);
+                // Segments are always written and read from the beginning to the end.
+                ::madvise(this->data, this->capacity, MADV_SEQUENTIAL);
+            }
+
+            /**
+             * Destructor.
+             * @throw None.
+             */
+            ~segment() noexcept
+            {
+                ::munmap(this->data, this->capacity);
+                ::close(this->fd);
+            }
+
+            /**
+             * Checks whether a record fits the rest of segment.
+             * @param size [in] - A size of record payload.
+             * @return true, if the record fits, otherwise false.
+             */
+            auto fits(const size_t & size) const -> bool
+            {
+                return this->capacity - this->written >= sizeof(uint32_t) + size;
+            }
+
+            /**
+             * Gets a payload of record at the end of segment, the record is not added until it is committed.
+             * @return A pointer to the record payload.
+             */
+            auto reserve() const -> char *
+            {
+                return this->data + this->written + sizeof(uint32_t);
+            }
+
+            /**
+             * Adds a record, which payload is written into the reserved memory.
+             * @param size [in] - A size of record payload.
+             */
+            auto commit(const size_t & size) -> void
+            {
+                const auto length = static_cast<uint32_t>(size);
+
+                std::memcpy(this->data + this->written, &length, sizeof(length));
+                this->written += sizeof(length) + size;
+            }
+
+            /**
+             * Gets the next unread record without skipping it.
+             * @param size [out] - A size of record payload.
+             * @return A pointer to the record payload.
+             */
+            auto peek(size_t & size) const -> const char *
+            {
+                uint32_t length = 0;
+
+                std::memcpy(&length, this->data + this->read, sizeof(length));
+                size = length;
+
+                return this->data + this->read + sizeof(length);
+            }
+
+            /**
+             * Skips the next unread record.
+             */
+            auto skip() -> void
+            {
+                uint32_t length = 0;
+
+                std::memcpy(&length, this->data + this->read, sizeof(length));
+                this->read += sizeof(length) + length;
+            }
+
+            /**
+             * Calls a callback for every unread record without reading it.
+             * @param callback [in] - A callback.
+             */
+            auto for_each(const std::function<void(const char * payload, size_t size)> & callback) const -> void
+            {
+                uint32_t length = 0;
+
+                for (auto offset = this->read; offset < this->written; offset += sizeof(length) + length)
+                {
+                    std::memcpy(&length, this->data + offset, sizeof(length));
+                    callback(this->data + offset + sizeof(length), length);
+                }
+            }
+
+            /**
+             * Checks the segment on unread records.
+             * @return true, if all written records are read, otherwise false.
+             */
+            auto drained() const -> bool
+            {
+                return this->read == this->written;
+            }
+
+            /**
+             * Makes the segment ready to be written from the beginning.
+             */
+            auto rewind() -> void
+            {
+                this->written = this->read = 0;
+            }
+        };
+//-------------------------------------------------------------------------//
+        template<typename TMessage>
+        class spill final : public overflow<TMessage>
+        {
+            using segment_t = std::unique_ptr<segment>;
+            //!< Keeps a codec of messages.
+            std::shared_ptr<ICodec<TMessage>> codec;
+            //!< Keeps a directory of segment files.
+            const std::string directory;
+            //!< Keeps a size of segment.
+            const size_t length = SPILL_SEGMENT_SIZE;
+            //!< Keeps a max count of drained segments kept for reuse.
+            const size_t spare = SPILL_SPARE_SEGMENTS;
+            //!< Keeps a list of segments with records (the first one is read, the last one is written).
+            std::deque<segment_t> segments;
+            //!< Keeps a list of drained segments.
+            std::vector<segment_t> recycled;
+            //!< Keeps a count of records.
+            size_t count = 0;
+
+        public:
+            /**
+             * Constructor.
+             * @param codec [in] - A codec of messages.
+             * @param directory [in] - A directory of segment files.
+             * @param size [in] - A size of segment.
+             * @param spare [in] - A max count of drained segments kept for reuse.
+             * @throw std::invalid_argument - No codec.
+             */
+            spill(std::shared_ptr<ICodec<TMessage>> codec, const std::string & directory,
+                  const size_t & size = SPILL_SEGMENT_SIZE, const size_t & spare = SPILL_SPARE_SEGMENTS)
+                : codec(std::move(codec)), directory(directory), length(size), spare(spare)
+            {
+                if (this->codec == nullptr) { throw (std::invalid_argument("No codec of spilled messages.")); }
+            }
+
+            /**
+             * Destructor.
+             * @throw None.
+             */
+            ~spill() noexcept = default;
+
+            /**
+             * Appends a message to the end of log.
+             * @param message [in] - A message.
+             * @throw std::length_error - The message does not fit a segment.
+             */
+            virtual auto push(const TMessage & message) -> void override
+            {
+                const auto size = this->codec->Size(message);
+
+                if (size > UINT32_MAX || sizeof(uint32_t) + size > this->length)
+                {
+                    throw (std::length_error("Too large message to spill [" + std::to_string(size) + "]"));
+                }
+                if (this->segments.empty() != true && this->segments.back()->fits(size) != false)
+                {
+                    // The record is added only after the message is encoded, the codec may throw.
+                    this->codec->Encode(message, this->segments.back()->reserve());
+                    this->segments.back()->commit(size);
+                }
+                else
+                {
+                    auto object = this->acquire();
+
+                    try
+                    {
+                        this->codec->Encode(message, object->reserve());
+                    }
+                    catch (...)
+                    {
+                        this->release(std::move(object));
+                        throw;
+                    }
+                    object->commit(size);
+                    this->segments.push_back(std::move(object));
+                }
+                ++this->count;
+            }
+
+            /**
+             * Gets the first message from the log and removes it. A record, which cannot be decoded, is dropped,
+             * so it does not block later messages, and the error of codec is passed to the caller.
+             * @return The first message.
+             * @throw std::out_of_range - No one message found.
+             */
+            virtual auto pop() -> TMessage override
+            {
+                if (this->count == 0) { throw (std::out_of_range("No one message found.")); }
+
+                size_t size = 0;
+                auto payload = this->segments.front()->peek(size);
+
+                try
+                {
+                    auto message = this->codec->Decode(payload, size);
+
+                    this->skip();
+
+                    return message;
+                }
+                catch (...)
+                {
+                    this->skip();
+                    throw;
+                }
+            }
+
+            /**
+             * Calls a callback for every message in the log in order without removing it.
+             * @param callback [in] - A callback.
+             */
+            virtual auto for_each(const std::function<void(const TMessage & message)> & callback) const -> void override
+            {
+                for (const auto & object : this->segments)
+                {
+                    object->for_each([this, &callback](const char * payload, size_t size) -> void {
+                        callback(this->codec->Decode(payload, size));
+                    });
+                }
+            }
+
+            /**
+             * Checks the log on empty.
+             * @return true, if the log is empty, otherwise false.
+             */
+            virtual auto empty() const -> bool override
+            {
+                return this->count == 0;
+            }
+
+            /**
+             * Gets a count of messages in the log.
+             * @return A count of messages.
+             */
+            virtual auto size() const -> size_t override
+            {
+                return this->count;
+            }
+
+        protected:
+            //!< Gets a segment to write, a recycled one if any.
+            auto acquire() -> segment_t
+            {
+                if (this->recycled.empty() != true)
+                {
+                    auto object = std::move(this->recycled.back());
+                    this->recycled.pop_back();
+
+                    return object;
+                }
+                return segment_t(new segment(this->directory, this->length));
+            }
+
+            //!< Removes the first record, a drained segment is reused.
+            auto skip() -> void
+            {
+                auto & front = this->segments.front();
+
+                front->skip();
+                --this->count;
+
+                if (front->drained() != false)
+                {
+                    if (this->segments.size() > 1)
+                    {// The writer has moved on, so the segment can be reused.
+                        this->release(std::move(front));
+                        this->segments.pop_front();
+                    }
+                    else
+                    {
+                        front->rewind();
+                    }
+                }
+            }
+
+            //!< Keeps a drained segment for reuse or frees it.
+            auto release(segment_t object) -> void
+            {
+                if (this->recycled.size() < this->spare)
+                {
+                    object->rewind();
+                    this->recycled.push_back(std::move(object));
+                }
+            }
+        };
+//-------------------------------------------------------------------------//
+    }; // namespace storage
+}; // namespace multiqueue
+//-------------------------------------------------------------------------//
+#endif // __STORAGE_SPILL_H_E2B6D41F_93C7_4A05_B8D2_5F0A7C13E964__
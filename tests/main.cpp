@@ -19,7 +19,15 @@
 //-------------------------------------------------------------------------//
 #include "units/gtest-queue.h"
 #include "units/gtest-map.h"
+#include "units/gtest-pool.h"
+#include "units/gtest-slot.h"
+#include "units/gtest-spill.h"
+#include "units/gtest-snapshot.h"
+#include "units/gtest-message.h"
 #include "units/gtest-processor.h"
+#include "units/gtest-trace.h"
+#include "units/gtest-coroutine.h"
+#include "units/gtest-shared.h"
 //-------------------------------------------------------------------------//
 int main(int argc, char ** argv)
 {
@@ -0,0 +1,47 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-codec.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_CODEC_H_1B7D9E40_C3A5_4E12_8F6B_D2E05A94C731__
+#define __GTEST_CODEC_H_1B7D9E40_C3A5_4E12_8F6B_D2E05A94C731__
+//-------------------------------------------------------------------------//
+#include <string>
+#include <cstring>
+//-------------------------------------------------------------------------//
+#include "../../storage-codec.h"
+//-------------------------------------------------------------------------//
+namespace
+{
+    class string_codec : public multiqueue::ICodec<std::string>
+    {
+    public:
+        virtual auto Size(const std::string & value) -> size_t override
+        {
+            return value.size();
+        }
+
+        virtual auto Encode(const std::string & value, char * buffer) -> void override
+        {
+            std::memcpy(buffer, value.data(), value.size());
+        }
+
+        virtual auto Decode(const char * buffer, size_t size) -> std::string override
+        {
+            return std::string(buffer, size);
+        }
+    };
+}; // namespace
+//-------------------------------------------------------------------------//
+#endif // __GTEST_CODEC_H_1B7D9E40_C3A5_4E12_8F6B_D2E05A94C731__
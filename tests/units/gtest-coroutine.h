@@ -0,0 +1,169 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-coroutine.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_COROUTINE_H_C5A18E73_2D9F_4B60_97E4_0F3B6A8D21C5__
+#define __GTEST_COROUTINE_H_C5A18E73_2D9F_4B60_97E4_0F3B6A8D21C5__
+//-------------------------------------------------------------------------//
+#include <atomic>
+#include <thread>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../MultiQueueProcessor.h"
+//-------------------------------------------------------------------------//
+#ifdef MULTIQUEUE_COROUTINES
+namespace
+{
+    using async_processor_t = multiqueue::MultiQueueProcessor<int, int>;
+
+    auto reader(async_processor_t & processor, int key, int count, std::atomic_int & sum, std::atomic_bool & ordered) -> multiqueue::coroutine::task
+    {
+        for (auto i = 0; i < count; ++i)
+        {
+            const auto value = co_await processor.Next(key);
+
+            if (value != i) { ordered = false; }
+
+            sum += value;
+        }
+    }
+
+    class async_consumer : public multiqueue::IAsyncConsumer<int, int>
+    {
+    public:
+        //!< Keeps a processor of replies.
+        async_processor_t & processor;
+        //!< Keeps a count of suspended tasks.
+        std::atomic_int suspended;
+        //!< Keeps a count of messages.
+        std::atomic_int count;
+        //!< Keeps a flag of wrong order or of more than one task per key.
+        std::atomic_bool ordered;
+        //!< Keeps a count of messages and a flag of running task per key.
+        int counts[100];
+        std::atomic_bool running[100];
+
+        explicit async_consumer(async_processor_t & processor) : processor(processor), suspended(0), count(0), ordered(true)
+        {
+            for (auto i = 0; i < 100; ++i) { counts[i] = 0; running[i] = false; }
+        }
+
+        virtual auto Consume(const int & id, const int & value) -> multiqueue::coroutine::task override
+        {
+            if (this->running[id].exchange(true) != false || value != this->counts[id]) { this->ordered = false; }
+
+            ++this->suspended;
+            // Waiting for a reply without a thread.
+            const auto reply = co_await this->processor.Next(1000 + id);
+            --this->suspended;
+
+            if (reply != value) { this->ordered = false; }
+
+            ++this->counts[id];
+            this->running[id] = false;
+            ++this->count;
+        }
+    };
+}; // namespace
+//-------------------------------------------------------------------------//
+TEST(TestCoroutine, next)
+{
+    async_processor_t processor;
+    std::atomic_int sum(0);
+    std::atomic_bool ordered(true), done(false);
+
+    processor.Enqueue(1, 0);
+
+    auto task = reader(processor, 1, 100, sum, ordered);
+    task.start([&done](std::exception_ptr) { done = true; });
+    // The reader has taken the first message and waits for others.
+    ASSERT_TRUE(sum == 0);
+    ASSERT_FALSE(done);
+
+    for (auto i = 1; i < 100; ++i) { processor.Enqueue(1, i); }
+    while (done != true) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(sum == 4950);
+    ASSERT_TRUE(processor.Size(1) == 0);
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+
+TEST(TestCoroutine, consumer)
+{
+    multiqueue::Options<int, int> options;
+    options.maximum = 2;
+
+    async_processor_t processor(options);
+    async_consumer consumer(processor);
+
+    for (auto key = 0; key < 100; ++key)
+    {
+        processor.Subscribe(key, &consumer);
+
+        for (auto i = 0; i < 5; ++i) { processor.Enqueue(key, i); }
+    }
+    for (auto i = 0; i < 5; ++i)
+    {
+        // Every key waits for a reply, while two threads dispatch them.
+        while (consumer.suspended != 100) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+        for (auto key = 0; key < 100; ++key) { processor.Enqueue(1000 + key, i); }
+    }
+    while (consumer.count != 500) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    ASSERT_TRUE(consumer.ordered);
+
+    for (auto key = 0; key < 100; ++key) { processor.Unsubscribe(key); }
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+
+TEST(TestCoroutine, stop)
+{
+    async_processor_t processor;
+    std::atomic_int sum(0);
+    std::atomic_bool ordered(true), done(false), failed(false);
+
+    auto task = reader(processor, 1, 2, sum, ordered);
+    task.start([&done, &failed](std::exception_ptr error) { failed = error != nullptr; done = true; });
+    ASSERT_FALSE(done);
+    // The parked reader is resumed with an error rather than left suspended.
+    processor.StopProcessing();
+    ASSERT_TRUE(done);
+    ASSERT_TRUE(failed);
+    // Messages are not passed to coroutines after the processing is stopped.
+    processor.Enqueue(1, 0);
+    ASSERT_TRUE(processor.Size(1) == 1);
+
+    done = false;
+    auto other = reader(processor, 1, 2, sum, ordered);
+    other.start([&done, &failed](std::exception_ptr error) { failed = error != nullptr; done = true; });
+    // The queued message is taken, then Next fails at once instead of parking.
+    ASSERT_TRUE(done);
+    ASSERT_TRUE(failed);
+    ASSERT_TRUE(processor.Size(1) == 0);
+    ASSERT_TRUE(ordered);
+
+    processor.Wait();
+}
+#endif // MULTIQUEUE_COROUTINES
+//-------------------------------------------------------------------------//
+#endif // __GTEST_COROUTINE_H_C5A18E73_2D9F_4B60_97E4_0F3B6A8D21C5__
@@ -18,6 +18,7 @@
 #define __GTEST_MAP_H_03084F3E_47F8_4369_97B8_80E61A679901__
 //-------------------------------------------------------------------------//
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <thread>
 #include <atomic>
@@ -100,5 +101,19 @@ TEST(TestMap, contains)
     ASSERT_TRUE(map.contains(1));
     ASSERT_FALSE(map.contains(2));
 }
+
+TEST(TestMap, transparent)
+{
+    multiqueue::concurrency::map<std::string, int> map;
+    const auto & objects = map;
+
+    ASSERT_NO_THROW(map.insert({"tenant-1", 1}));
+    ASSERT_TRUE(map.contains("tenant-1"));
+    ASSERT_TRUE(map.contains(std::string_view("tenant-1")));
+    ASSERT_FALSE(map.contains(std::string_view("tenant-2")));
+    ASSERT_TRUE(map.find(std::string_view("tenant-1")) == 1);
+    ASSERT_TRUE(objects.find("tenant-1") == 1);
+    ASSERT_THROW(map.find("tenant-2"), std::invalid_argument);
+}
 //-------------------------------------------------------------------------//
 #endif // __GTEST_MAP_H_03084F3E_47F8_4369_97B8_80E61A679901__
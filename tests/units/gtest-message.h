@@ -0,0 +1,111 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-message.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_MESSAGE_H_6F2A9C41_B83D_4E07_A5D1_0C7E4B92F316__
+#define __GTEST_MESSAGE_H_6F2A9C41_B83D_4E07_A5D1_0C7E4B92F316__
+//-------------------------------------------------------------------------//
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../MultiQueueProcessor.h"
+//-------------------------------------------------------------------------//
+namespace
+{
+    using message_t = multiqueue::storage::message<>;
+
+    class message_consumer : public multiqueue::IConsumer<int, message_t>
+    {
+    public:
+        //!< Keeps a count of messages.
+        std::atomic_int count;
+        //!< Keeps a flag of wrong order.
+        std::atomic_bool ordered;
+
+        message_consumer() : count(0), ordered(true) {}
+
+        virtual auto Consume(const int &, const message_t & value) -> void override
+        {
+            // Small and large messages alternate.
+            const auto text = std::to_string(this->count) + std::string(this->count % 2 == 0 ? 0 : 100, '.');
+
+            if (value.view() != text) { this->ordered = false; }
+
+            ++this->count;
+        }
+    };
+}; // namespace
+//-------------------------------------------------------------------------//
+TEST(TestMessage, storage)
+{
+    // The inline data and the count of bytes fill one line.
+    ASSERT_TRUE(sizeof(message_t) == 64);
+    ASSERT_TRUE(alignof(message_t) == 64);
+    ASSERT_TRUE(message_t::inline_size == 60);
+
+    const std::string small(message_t::inline_size, 's'), large(100, 'l');
+    message_t first(small), second(large);
+
+    ASSERT_FALSE(first.outline());
+    ASSERT_TRUE(second.outline());
+    ASSERT_TRUE(first.view() == small);
+    ASSERT_TRUE(second.view() == large);
+
+    auto copy = second;
+    ASSERT_TRUE(copy.view() == large);
+    ASSERT_TRUE(copy.data() != second.data());
+
+    const auto buffer = second.data();
+    auto moved = std::move(second);
+    ASSERT_TRUE(moved.data() == buffer);
+    ASSERT_TRUE(second.size() == 0);
+
+    moved = first;
+    ASSERT_TRUE(moved.view() == small);
+    // The buffer is given back to the pool and reused.
+    message_t other(large);
+    ASSERT_TRUE(other.data() == buffer);
+
+    multiqueue::storage::message_codec<> codec;
+    char encoded[128];
+    codec.Encode(other, encoded);
+    ASSERT_TRUE(codec.Decode(encoded, codec.Size(other)).view() == large);
+}
+
+TEST(TestMessage, processor)
+{
+    multiqueue::MultiQueueProcessor<int, message_t> processor;
+    message_consumer consumer;
+    const auto count = 10000;
+
+    processor.Subscribe(1, &consumer);
+
+    for (auto i = 0; i < count; ++i)
+    {
+        processor.Enqueue(1, message_t(std::to_string(i) + std::string(i % 2 == 0 ? 0 : 100, '.')));
+    }
+    while (consumer.count != count) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    ASSERT_TRUE(consumer.ordered);
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+//-------------------------------------------------------------------------//
+#endif // __GTEST_MESSAGE_H_6F2A9C41_B83D_4E07_A5D1_0C7E4B92F316__
@@ -0,0 +1,121 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-pool.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_POOL_H_58C1E2A7_9B04_4D3F_8E76_A2F0D13C59B4__
+#define __GTEST_POOL_H_58C1E2A7_9B04_4D3F_8E76_A2F0D13C59B4__
+//-------------------------------------------------------------------------//
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../concurrency-pool.h"
+//-------------------------------------------------------------------------//
+TEST(TestPool, elastic)
+{
+    multiqueue::concurrency::pool pool(1, 4, 1, std::chrono::milliseconds(1), std::chrono::milliseconds(50));
+    std::atomic_bool blocked(true);
+    std::atomic_int count(0);
+
+    ASSERT_TRUE(pool.size() == 1);
+
+    for (auto i = 0; i < 16; ++i)
+    {
+        pool.submit([&blocked, &count]() {
+            while (blocked != false) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+            ++count;
+        });
+    }
+    // Every thread is busy, so the pool grows up to the max.
+    while (pool.size() != 4) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    blocked = false;
+
+    while (count != 16) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_TRUE(pool.pending() == 0);
+    ASSERT_TRUE(pool.size() <= 4);
+    // Idle threads retire down to the min.
+    while (pool.size() != 1) { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
+
+    pool.stop();
+    pool.wait();
+    ASSERT_TRUE(pool.size() == 0);
+}
+
+TEST(TestPool, empty)
+{
+    multiqueue::concurrency::pool pool(0, 2, 1, std::chrono::milliseconds(1), std::chrono::milliseconds(10));
+    std::atomic_int count(0);
+
+    ASSERT_TRUE(pool.size() == 0);
+    pool.submit([&count]() { ++count; });
+
+    while (count != 1) { std::this_thread::yield(); }
+    while (pool.size() != 0) { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }
+
+    pool.stop();
+    pool.submit([&count]() { ++count; });
+    pool.wait();
+    ASSERT_TRUE(count == 1);
+
+    ASSERT_THROW(multiqueue::concurrency::pool(2, 1, 1, std::chrono::milliseconds(1), std::chrono::milliseconds(1)), std::invalid_argument);
+}
+
+TEST(TestPool, latency)
+{
+    using clock_t = std::chrono::steady_clock;
+
+    multiqueue::concurrency::pool pool(1, 4, 4, std::chrono::milliseconds(1), std::chrono::milliseconds(50));
+    std::atomic_bool started(false), finished(false);
+    clock_t::time_point submitted, run;
+
+    pool.submit([&started]() {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    });
+    while (started != true) { std::this_thread::yield(); }
+    // The backlog is not exceeded and no other task is submitted, so only the latency adds a thread.
+    submitted = clock_t::now();
+    pool.submit([&run, &finished]() { run = clock_t::now(); finished = true; });
+
+    while (finished != true) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_TRUE(run - submitted < std::chrono::milliseconds(150));
+
+    pool.stop();
+    pool.wait();
+    for (auto i = 0; i < 5; ++i)
+    {
+        multiqueue::concurrency::pool other(1, 4, 4, std::chrono::milliseconds(1), std::chrono::seconds(1));
+        // The only thread is idle.
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        finished = false;
+        // A burst: the idle thread is notified for the first task, but has not woken yet, when the second one comes.
+        other.submit([]() { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+        submitted = clock_t::now();
+        other.submit([&run, &finished]() { run = clock_t::now(); finished = true; });
+
+        while (finished != true) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+        ASSERT_TRUE(run - submitted < std::chrono::milliseconds(100));
+
+        other.stop();
+        other.wait();
+    }
+}
+//-------------------------------------------------------------------------//
+#endif // __GTEST_POOL_H_58C1E2A7_9B04_4D3F_8E76_A2F0D13C59B4__
@@ -18,8 +18,13 @@
 #define __GTEST_PROCESSOR_H_EEE5A9DC_9450_4945_988B_EE8DFEDB6ABC__
 //-------------------------------------------------------------------------//
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <atomic>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
 //-------------------------------------------------------------------------//
 #include <gtest/gtest.h>
 //-------------------------------------------------------------------------//
@@ -37,6 +42,92 @@ namespace
             std::clog << "Key = " << id << ", value = " << value << std::endl;
         }
     };
+
+    class ordered_consumer : public multiqueue::IConsumer<std::string, std::string>
+    {
+        using base_class = multiqueue::IConsumer<std::string, std::string>;
+
+    public:
+        //!< Keeps a count of messages per key.
+        std::atomic_int counts[8];
+        //!< Keeps a flag of wrong order.
+        std::atomic_bool ordered;
+
+        ordered_consumer() : ordered(true) { for (auto & count : counts) { count = 0; } }
+
+        virtual auto Consume(const base_class::key_type & id, const base_class::value_type & value) -> void override
+        {
+            auto & count = this->counts[std::stoi(id)];
+
+            if (value != std::to_string(count)) { this->ordered = false; }
+
+            ++count;
+        }
+    };
+
+    class stalled_consumer : public multiqueue::IConsumer<std::string, std::string>
+    {
+        using base_class = multiqueue::IConsumer<std::string, std::string>;
+
+    public:
+        //!< Keeps a count of slow messages of key "0".
+        std::atomic_int slow;
+        //!< Keeps a count of messages per key.
+        std::atomic_int counts[2];
+
+        stalled_consumer() : slow(0) { counts[0] = counts[1] = 0; }
+
+        virtual auto Consume(const base_class::key_type & id, const base_class::value_type &) -> void override
+        {
+            if (id == "0" && this->slow > 0)
+            {
+                --this->slow;
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            ++this->counts[std::stoi(id)];
+        }
+    };
+
+    class blocked_consumer : public multiqueue::IConsumer<std::string, std::string>
+    {
+        using base_class = multiqueue::IConsumer<std::string, std::string>;
+
+    public:
+        //!< Keeps a flag of blocking Consume of key "0".
+        std::atomic_bool blocked;
+        //!< Keeps a count of messages per key.
+        std::atomic_int counts[2];
+
+        blocked_consumer() : blocked(true) { counts[0] = counts[1] = 0; }
+
+        virtual auto Consume(const base_class::key_type & id, const base_class::value_type &) -> void override
+        {
+            while (id == "0" && this->blocked != false) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+            ++this->counts[std::stoi(id)];
+        }
+    };
+
+    class churn_consumer : public multiqueue::IConsumer<std::string, std::string>
+    {
+        using base_class = multiqueue::IConsumer<std::string, std::string>;
+
+    public:
+        //!< Keeps a flag of being in Consume.
+        std::atomic_bool busy;
+        //!< Keeps a count of messages.
+        std::atomic_int count;
+
+        churn_consumer() : busy(false), count(0) {}
+
+        virtual auto Consume(const base_class::key_type &, const base_class::value_type &) -> void override
+        {
+            this->busy = true;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++this->count;
+            this->busy = false;
+        }
+    };
 }; // namespace
 //-------------------------------------------------------------------------//
 TEST(TestQueue, multiqueue)
@@ -87,5 +178,188 @@ TEST(TestQueue, multiqueue)
     processor.Wait();
     manager.join();
 }
+
+TEST(TestQueue, ordered)
+{
+    using queue_processor_t = multiqueue::MultiQueueProcessor<std::string, std::string>;
+
+    multiqueue::Options<std::string, std::string> options;
+    options.minimum = 0;
+    options.maximum = 4;
+
+    ordered_consumer consumer;
+    queue_processor_t processor(options);
+
+    for (auto key = 0; key < 8; ++key)
+    {
+        processor.Subscribe(std::to_string(key), &consumer);
+    }
+    std::vector<std::thread> producers;
+
+    for (auto key = 0; key < 8; ++key)
+    {
+        producers.emplace_back([key](queue_processor_t & processor) -> void {
+            for (auto i = 0; i < 1000; ++i)
+            {
+                processor.Enqueue(std::to_string(key), std::to_string(i));
+            }
+        }, std::ref(processor));
+    }
+    for (auto & producer : producers) { producer.join(); }
+
+    for (auto key = 0; key < 8; ++key)
+    {
+        while (consumer.counts[key] != 1000) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    }
+    processor.StopProcessing();
+    processor.Wait();
+
+    ASSERT_TRUE(consumer.ordered);
+}
+
+TEST(TestQueue, isolation)
+{
+    using queue_processor_t = multiqueue::MultiQueueProcessor<std::string, std::string>;
+
+    multiqueue::Options<std::string, std::string> options;
+    options.minimum = 1;
+    options.maximum = 1;
+    options.budget = std::chrono::milliseconds(5);
+
+    stalled_consumer consumer;
+    consumer.slow = 10;
+    queue_processor_t processor(options);
+
+    processor.Subscribe("0", &consumer);
+    processor.Subscribe("1", &consumer);
+
+    for (auto i = 0; i < 10; ++i) { processor.Enqueue("0", std::to_string(i)); }
+
+    while (processor.Isolated("0") != true) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    // The only shared thread is free, while the stalled consumer is isolated.
+    for (auto i = 0; i < 1000; ++i) { processor.Enqueue("1", std::to_string(i)); }
+
+    while (consumer.counts[1] != 1000) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_TRUE(consumer.counts[0] < 10);
+
+    while (consumer.counts[0] != 10) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    // The consumer recovers on fast messages.
+    for (auto i = 0; i < 1000; ++i) { processor.Enqueue("0", std::to_string(i)); }
+
+    while (consumer.counts[0] != 1010) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_FALSE(processor.Isolated("0"));
+    ASSERT_FALSE(processor.Isolated("1"));
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+
+TEST(TestQueue, watchdog)
+{
+    using queue_processor_t = multiqueue::MultiQueueProcessor<std::string, std::string>;
+
+    multiqueue::Options<std::string, std::string> options;
+    options.minimum = 1;
+    options.maximum = 1;
+    options.budget = std::chrono::milliseconds(5);
+
+    blocked_consumer consumer;
+    queue_processor_t processor(options);
+
+    processor.Subscribe("0", &consumer);
+    processor.Subscribe("1", &consumer);
+    processor.Enqueue("0", "0");
+    // The consumer is isolated, while its first Consume is still blocking the only shared thread.
+    while (processor.Isolated("0") != true) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    for (auto i = 0; i < 100; ++i) { processor.Enqueue("1", std::to_string(i)); }
+
+    while (consumer.counts[1] != 100) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_TRUE(consumer.counts[0] == 0);
+    ASSERT_TRUE(processor.Isolated("0"));
+
+    consumer.blocked = false;
+
+    while (consumer.counts[0] != 1) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+
+TEST(TestQueue, unsubscribe)
+{
+    using queue_processor_t = multiqueue::MultiQueueProcessor<std::string, std::string>;
+
+    multiqueue::Options<std::string, std::string> options;
+    options.maximum = 4;
+
+    queue_processor_t processor(options);
+    std::atomic_bool running(true);
+
+    std::thread producer([&processor, &running]() {
+        for (auto i = 0; running != false; ++i)
+        {
+            processor.Enqueue(std::to_string(i % 4), std::to_string(i));
+            std::this_thread::yield();
+        }
+    });
+    // Subscriptions churn, while messages are dispatched.
+    for (auto i = 0; i < 200; ++i)
+    {
+        const auto key = std::to_string(i % 4);
+        std::unique_ptr<churn_consumer> consumer(new churn_consumer());
+
+        processor.Subscribe(key, consumer.get());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        processor.Unsubscribe(key);
+        // The consumer is idle and may be freed.
+        ASSERT_FALSE(consumer->busy);
+
+        const auto count = consumer->count.load();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        ASSERT_TRUE(consumer->count == count);
+    }
+    running = false;
+    producer.join();
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+
+TEST(TestQueue, intern)
+{
+    using queue_processor_t = multiqueue::MultiQueueProcessor<std::string, std::string>;
+
+    queue_processor_t processor;
+    ordered_consumer consumer;
+    const std::string tenant = "1";
+
+    processor.Enqueue(std::string_view(tenant), "0");
+    processor.Enqueue("1", "1");
+
+    auto handle = processor.Intern(std::string_view("1"));
+    ASSERT_TRUE(handle);
+    ASSERT_TRUE(handle.key() == "1");
+    ASSERT_TRUE(processor.Size(handle) == 2);
+    ASSERT_TRUE(processor.Size("1") == 2);
+    ASSERT_TRUE(processor.Size(std::string_view("2")) == 0);
+
+    for (auto i = 2; i < 100; ++i)
+    {
+        processor.Enqueue(handle, std::to_string(i));
+    }
+    ASSERT_TRUE(processor.Dequeue(handle) == "0");
+    ASSERT_TRUE(processor.Dequeue("1") == "1");
+    // Messages of interned and not interned keys are kept in the same queue, the first two are taken already.
+    consumer.counts[1] = 2;
+    processor.Subscribe(std::string_view(tenant), &consumer);
+
+    while (processor.Size(handle) != 0 || consumer.counts[1] != 100) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_TRUE(consumer.ordered);
+    ASSERT_THROW(processor.Dequeue(handle), std::invalid_argument);
+
+    processor.StopProcessing();
+    processor.Wait();
+}
 //-------------------------------------------------------------------------//
 #endif // __GTEST_PROCESSOR_H_EEE5A9DC_9450_4945_988B_EE8DFEDB6ABC__
@@ -18,6 +18,7 @@
 #define __GTEST_QUEUE_H_B0A3730A_0088_4EF2_A420_61C39ED7FAF1__
 //-------------------------------------------------------------------------//
 #include <string>
+#include <deque>
 #include <stdexcept>
 #include <thread>
 #include <atomic>
@@ -124,5 +125,47 @@ TEST(TestQueue, dequeueAsync)
     ASSERT_TRUE(count == 20);
     ASSERT_THROW(queue.dequeue(), std::out_of_range);
 }
+
+TEST(TestQueue, ring)
+{
+    multiqueue::storage::ring<std::string> ring;
+    auto first = 0, last = 0;
+    // Messages wrap around slots, while the ring grows and shrinks.
+    for (auto round = 0; round < 4; ++round)
+    {
+        for (auto i = 0; i < 1000; ++i) { ring.push_back(std::to_string(last++)); }
+
+        ASSERT_TRUE(ring.size() == static_cast<size_t>(last - first));
+        ASSERT_TRUE(ring[1] == std::to_string(first + 1));
+
+        while (ring.size() > 10)
+        {
+            ASSERT_TRUE(ring.front() == std::to_string(first++));
+            ring.pop_front();
+        }
+    }
+    while (ring.empty() != true)
+    {
+        ASSERT_TRUE(ring.front() == std::to_string(first++));
+        ring.pop_front();
+    }
+    ASSERT_TRUE(first == last);
+}
+
+TEST(TestQueue, append)
+{
+    multiqueue::concurrency::queue<std::string> queue(10);
+    std::deque<std::string> objects;
+
+    queue.enqueue("0");
+
+    for (auto i = 1; i < 100; ++i) { objects.push_back(std::to_string(i)); }
+    // Without the overflow, messages beyond the capacity are kept in memory.
+    queue.append(std::move(objects));
+    ASSERT_TRUE(queue.size() == 100);
+
+    for (auto i = 0; i < 100; ++i) { ASSERT_TRUE(queue.dequeue() == std::to_string(i)); }
+    ASSERT_TRUE(queue.empty());
+}
 //-------------------------------------------------------------------------//
 #endif // __GTEST_QUEUE_H_B0A3730A_0088_4EF2_A420_61C39ED7FAF1__
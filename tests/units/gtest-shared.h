@@ -0,0 +1,182 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-shared.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_SHARED_H_D83B06E4_1F5A_4C27_9A6E_3C0B8F2D71E5__
+#define __GTEST_SHARED_H_D83B06E4_1F5A_4C27_9A6E_3C0B8F2D71E5__
+//-------------------------------------------------------------------------//
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <unistd.h>
+#include <sys/wait.h>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../SharedMultiQueueProcessor.h"
+//-------------------------------------------------------------------------//
+namespace
+{
+    using shared_message_t = multiqueue::interprocess::bytes<32>;
+
+    class shared_consumer : public multiqueue::IConsumer<int, shared_message_t>
+    {
+    public:
+        //!< Keeps a count of messages per key.
+        std::atomic_int counts[2];
+        //!< Keeps a flag of wrong order.
+        std::atomic_bool ordered;
+
+        shared_consumer() : ordered(true) { counts[0] = counts[1] = 0; }
+
+        virtual auto Consume(const int & id, const shared_message_t & value) -> void override
+        {
+            if (std::string(value.data(), value.size()) != std::to_string(this->counts[id])) { this->ordered = false; }
+
+            ++this->counts[id];
+        }
+    };
+}; // namespace
+//-------------------------------------------------------------------------//
+TEST(TestShared, processes)
+{
+    using queue_processor_t = multiqueue::SharedMultiQueueProcessor<int, shared_message_t>;
+
+    const auto name = "/multiqueue-gtest-" + std::to_string(::getpid());
+    const auto count = 10000;
+
+    queue_processor_t::Remove(name);
+    // Forking before any thread is started by the processor.
+    auto pid = ::fork();
+    ASSERT_TRUE(pid >= 0);
+
+    if (pid == 0)
+    {// A producer process, the ring is smaller than the count, so the producer waits for the consumer.
+        queue_processor_t processor(name, 16, 256);
+
+        for (auto i = 0; i < count; ++i)
+        {
+            shared_message_t message;
+            const auto text = std::to_string(i);
+            message.assign(text.data(), text.size());
+
+            processor.Enqueue(i % 2, message);
+            processor.Enqueue((i + 1) % 2, message);
+        }
+        ::_exit(0);
+    }
+    shared_consumer consumer;
+    queue_processor_t processor(name, 16, 256);
+
+    processor.Subscribe(0, &consumer);
+    processor.Subscribe(1, &consumer);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+    while (consumer.counts[0] + consumer.counts[1] != 2 * count && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    processor.StopProcessing();
+    processor.Wait();
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    queue_processor_t::Remove(name);
+
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    ASSERT_TRUE(consumer.counts[0] == count);
+    ASSERT_TRUE(consumer.counts[1] == count);
+    ASSERT_TRUE(consumer.ordered);
+}
+
+TEST(TestShared, threads)
+{
+    using queue_processor_t = multiqueue::SharedMultiQueueProcessor<int, shared_message_t>;
+
+    const auto name = "/multiqueue-gtest-threads-" + std::to_string(::getpid());
+
+    queue_processor_t::Remove(name);
+    queue_processor_t processor(name, 16, 64);
+
+    std::thread producer1([&processor]() {
+        for (auto i = 0; i < 1000; ++i) { processor.Enqueue(0, shared_message_t()); }
+    });
+    std::thread producer2([&processor]() {
+        for (auto i = 0; i < 10; ++i) { processor.Enqueue(1, shared_message_t()); }
+    });
+    producer2.join();
+    ASSERT_TRUE(processor.Size(1) == 10);
+    ASSERT_TRUE(processor.Size(2) == 0);
+
+    // The ring of key 0 is full until somebody consumes it.
+    class counter : public multiqueue::IConsumer<int, shared_message_t>
+    {
+    public:
+        std::atomic_int count;
+
+        counter() : count(0) {}
+
+        virtual auto Consume(const int &, const shared_message_t &) -> void override { ++this->count; }
+    } consumer;
+
+    processor.Subscribe(0, &consumer);
+    producer1.join();
+
+    while (consumer.count != 1000) { std::this_thread::yield(); }
+
+    processor.StopProcessing();
+    processor.Wait();
+    queue_processor_t::Remove(name);
+
+    ASSERT_TRUE(processor.Size(0) == 0);
+    ASSERT_TRUE(processor.Size(1) == 10);
+    ASSERT_THROW(queue_processor_t(name, 10, 64), std::invalid_argument);
+}
+
+TEST(TestShared, owner)
+{
+    using queue_processor_t = multiqueue::SharedMultiQueueProcessor<int, shared_message_t>;
+
+    class counter : public multiqueue::IConsumer<int, shared_message_t>
+    {
+    public:
+        virtual auto Consume(const int &, const shared_message_t &) -> void override {}
+    } consumer;
+
+    const auto name = "/multiqueue-gtest-owner-" + std::to_string(::getpid());
+
+    queue_processor_t::Remove(name);
+    {
+        queue_processor_t first(name, 16, 64);
+        queue_processor_t second(name, 16, 64);
+
+        first.Subscribe(0, &consumer);
+        first.Subscribe(0, &consumer);
+        // Two dispatchers never read the same ring.
+        ASSERT_THROW(second.Subscribe(0, &consumer), std::logic_error);
+        ASSERT_NO_THROW(second.Subscribe(1, &consumer));
+
+        first.Unsubscribe(0);
+        ASSERT_NO_THROW(second.Subscribe(0, &consumer));
+        ASSERT_THROW(first.Subscribe(0, &consumer), std::logic_error);
+    }
+    queue_processor_t::Remove(name);
+}
+//-------------------------------------------------------------------------//
+#endif // __GTEST_SHARED_H_D83B06E4_1F5A_4C27_9A6E_3C0B8F2D71E5__
@@ -0,0 +1,71 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-slot.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_SLOT_H_E9A3F5C8_6D17_4B02_A84E_1C7B0F3D2E95__
+#define __GTEST_SLOT_H_E9A3F5C8_6D17_4B02_A84E_1C7B0F3D2E95__
+//-------------------------------------------------------------------------//
+#include <thread>
+#include <atomic>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../concurrency-slot.h"
+//-------------------------------------------------------------------------//
+TEST(TestSlot, attach)
+{
+    int first = 1, second = 2;
+    multiqueue::concurrency::slot<int> slot;
+
+    ASSERT_FALSE(slot.attached());
+    ASSERT_FALSE(slot.acquire());
+    ASSERT_TRUE(slot.attach(&first));
+    ASSERT_FALSE(slot.attach(&second));
+    ASSERT_TRUE(slot.attached());
+    {
+        auto object = slot.acquire();
+        ASSERT_TRUE(object);
+        ASSERT_TRUE(object.operator->() == &first);
+    }
+    ASSERT_TRUE(slot.detach() == &first);
+    ASSERT_FALSE(slot.acquire());
+    ASSERT_TRUE(slot.attach(&second));
+}
+
+TEST(TestSlot, quiesce)
+{
+    int object = 1;
+    multiqueue::concurrency::slot<int> slot;
+    std::atomic_bool acquired(false), released(false);
+
+    slot.attach(&object);
+
+    std::thread reader([&slot, &acquired, &released]() {
+        auto guard = slot.acquire();
+        acquired = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        released = true;
+    });
+    while (acquired != true) { std::this_thread::yield(); }
+
+    slot.detach();
+    slot.quiesce();
+    // The reader has released the object before quiesce returns.
+    ASSERT_TRUE(released);
+    reader.join();
+}
+//-------------------------------------------------------------------------//
+#endif // __GTEST_SLOT_H_E9A3F5C8_6D17_4B02_A84E_1C7B0F3D2E95__
@@ -0,0 +1,111 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-snapshot.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_SNAPSHOT_H_6F2A8C31_47E9_4B5D_A3C0_E81D5F9B2746__
+#define __GTEST_SNAPSHOT_H_6F2A8C31_47E9_4B5D_A3C0_E81D5F9B2746__
+//-------------------------------------------------------------------------//
+#include <string>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../MultiQueueProcessor.h"
+//-------------------------------------------------------------------------//
+#include "gtest-codec.h"
+//-------------------------------------------------------------------------//
+#ifdef MULTIQUEUE_STORAGE
+TEST(TestSnapshot, restore)
+{
+    using queue_processor_t = multiqueue::MultiQueueProcessor<std::string, std::string>;
+
+    multiqueue::Options<std::string, std::string> options;
+    options.keys = std::make_shared<string_codec>();
+    options.codec = std::make_shared<string_codec>();
+    options.capacity = 20;
+    options.overflow = testing::TempDir();
+    options.shards = 4;
+
+    const auto path = testing::TempDir() + "/multiqueue.snapshot";
+    {
+        queue_processor_t processor(options);
+        // No subscriber, so messages stay in the processor.
+        for (auto key = 0; key < 50; ++key)
+        {
+            for (auto i = 0; i < 100; ++i)
+            {
+                processor.Enqueue(std::to_string(key), std::to_string(i));
+            }
+        }
+        ASSERT_NO_THROW(processor.Snapshot(path));
+        // The snapshot does not remove messages.
+        ASSERT_TRUE(processor.Size("0") == 100);
+    }
+    queue_processor_t processor(options);
+
+    ASSERT_NO_THROW(processor.Restore(path));
+
+    for (auto key = 0; key < 50; ++key)
+    {
+        ASSERT_TRUE(processor.Size(std::to_string(key)) == 100);
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(processor.Dequeue(std::to_string(key)) == std::to_string(i));
+        }
+    }
+}
+
+TEST(TestSnapshot, empty)
+{
+    multiqueue::Options<std::string, std::string> options;
+    options.keys = std::make_shared<string_codec>();
+    options.codec = std::make_shared<string_codec>();
+
+    const auto path = testing::TempDir() + "/multiqueue-empty.snapshot";
+
+    multiqueue::MultiQueueProcessor<std::string, std::string> processor(options);
+
+    ASSERT_NO_THROW(processor.Snapshot(path));
+    ASSERT_NO_THROW(processor.Restore(path));
+    ASSERT_TRUE(processor.Size("1") == 0);
+}
+
+TEST(TestSnapshot, errors)
+{
+    multiqueue::Options<std::string, std::string> options;
+    options.keys = std::make_shared<string_codec>();
+    options.codec = std::make_shared<string_codec>();
+
+    const auto path = testing::TempDir() + "/multiqueue-corrupted.snapshot";
+    {
+        std::ofstream stream(path, std::ios::binary);
+        stream << "not a snapshot at all";
+    }
+    multiqueue::MultiQueueProcessor<std::string, std::string> processor(options);
+
+    ASSERT_THROW(processor.Restore(path), std::runtime_error);
+    ASSERT_THROW(processor.Restore(path + ".missing"), std::system_error);
+
+    multiqueue::MultiQueueProcessor<std::string, std::string> uncoded;
+
+    ASSERT_THROW(uncoded.Snapshot(path), std::invalid_argument);
+}
+#endif // MULTIQUEUE_STORAGE
+//-------------------------------------------------------------------------//
+#endif // __GTEST_SNAPSHOT_H_6F2A8C31_47E9_4B5D_A3C0_E81D5F9B2746__
@@ -0,0 +1,237 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-spill.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_SPILL_H_4C8E2A17_D5B3_4F69_A0E1_93B7F2C60D58__
+#define __GTEST_SPILL_H_4C8E2A17_D5B3_4F69_A0E1_93B7F2C60D58__
+//-------------------------------------------------------------------------//
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../concurrency-queue.h"
+#include "../../MultiQueueProcessor.h"
+//-------------------------------------------------------------------------//
+#include "gtest-codec.h"
+//-------------------------------------------------------------------------//
+#ifdef MULTIQUEUE_STORAGE
+#include "../../storage-spill.h"
+//-------------------------------------------------------------------------//
+namespace
+{
+    class faulty_codec : public string_codec
+    {
+    public:
+        //!< Keeps a count of failures of Decode left.
+        int failures = 1;
+
+        virtual auto Encode(const std::string & value, char * buffer) -> void override
+        {
+            std::memcpy(buffer, "garbage", 7);
+
+            if (value == "bad") { throw (std::runtime_error("Cannot encode")); }
+
+            string_codec::Encode(value, buffer);
+        }
+
+        virtual auto Decode(const char * buffer, size_t size) -> std::string override
+        {
+            if (std::string(buffer, size) == "retry" && this->failures-- > 0) { throw (std::runtime_error("Cannot decode")); }
+
+            return string_codec::Decode(buffer, size);
+        }
+    };
+
+    class counting_consumer : public multiqueue::IConsumer<std::string, std::string>
+    {
+        using base_class = multiqueue::IConsumer<std::string, std::string>;
+
+    public:
+        //!< Keeps a count of messages.
+        std::atomic_int count;
+
+        counting_consumer() : count(0) {}
+
+        virtual auto Consume(const base_class::key_type &, const base_class::value_type &) -> void override { ++this->count; }
+    };
+}; // namespace
+//-------------------------------------------------------------------------//
+TEST(TestSpill, order)
+{
+    // A few records per segment to pass segment boundaries many times.
+    multiqueue::storage::spill<std::string> spill(std::make_shared<string_codec>(), testing::TempDir(), 64, 1);
+    ASSERT_TRUE(spill.empty());
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        ASSERT_NO_THROW(spill.push("message " + std::to_string(i)));
+    }
+    ASSERT_TRUE(spill.size() == 1000);
+
+    for (auto i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(spill.pop() == "message " + std::to_string(i));
+    }
+    ASSERT_TRUE(spill.empty());
+    ASSERT_THROW(spill.pop(), std::out_of_range);
+}
+
+TEST(TestSpill, interleaved)
+{
+    multiqueue::storage::spill<std::string> spill(std::make_shared<string_codec>(), testing::TempDir(), 64, 1);
+    auto pushed = 0, popped = 0;
+
+    for (auto round = 0; round < 100; ++round)
+    {
+        for (auto i = 0; i < 7; ++i) { spill.push(std::to_string(pushed++)); }
+        for (auto i = 0; i < 5; ++i) { ASSERT_TRUE(spill.pop() == std::to_string(popped++)); }
+    }
+    while (spill.empty() != true) { ASSERT_TRUE(spill.pop() == std::to_string(popped++)); }
+    ASSERT_TRUE(pushed == popped);
+}
+
+TEST(TestSpill, codec)
+{
+    multiqueue::storage::spill<std::string> spill(std::make_shared<faulty_codec>(), testing::TempDir(), 64, 1);
+
+    for (auto i = 0; i < 20; ++i)
+    {
+        ASSERT_NO_THROW(spill.push(std::to_string(i)));
+        // A message, which cannot be encoded, leaves no record.
+        ASSERT_THROW(spill.push("bad"), std::runtime_error);
+    }
+    spill.push("retry");
+    ASSERT_TRUE(spill.size() == 21);
+
+    for (auto i = 0; i < 20; ++i) { ASSERT_TRUE(spill.pop() == std::to_string(i)); }
+    // A message, which cannot be decoded, is dropped, so later ones are read.
+    ASSERT_THROW(spill.pop(), std::runtime_error);
+    ASSERT_TRUE(spill.empty());
+
+    spill.push("retry");
+    spill.push("21");
+    ASSERT_TRUE(spill.pop() == "retry");
+    ASSERT_TRUE(spill.pop() == "21");
+    ASSERT_TRUE(spill.empty());
+}
+
+TEST(TestSpill, large)
+{
+    multiqueue::storage::spill<std::string> spill(std::make_shared<string_codec>(), testing::TempDir(), 64, 1);
+
+    ASSERT_THROW(spill.push(std::string(64, 'x')), std::length_error);
+    ASSERT_THROW(multiqueue::storage::spill<std::string>(nullptr, testing::TempDir()), std::invalid_argument);
+}
+
+TEST(TestSpill, queue)
+{
+    auto overflow = std::make_shared<multiqueue::storage::spill<std::string>>(std::make_shared<string_codec>(), testing::TempDir(), 256, 1);
+    multiqueue::concurrency::queue<std::string> queue(10, overflow);
+
+    std::thread producer([&queue]() {
+        for (auto i = 0; i < 1000; ++i)
+        {
+            ASSERT_NO_THROW(queue.enqueue(std::to_string(i)));
+        }
+    });
+    std::atomic_int count(0);
+
+    std::thread consumer([&queue, &count]() {
+        while (count != 1000)
+        {
+            try
+            {
+                ASSERT_TRUE(queue.dequeue() == std::to_string(count));
+                ++count;
+            }
+            catch (const std::out_of_range &)
+            {
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+
+    ASSERT_TRUE(queue.empty());
+    ASSERT_TRUE(overflow->empty());
+}
+
+TEST(TestSpill, processor)
+{
+    multiqueue::Options<std::string, std::string> options;
+    options.capacity = 10;
+    options.codec = std::make_shared<string_codec>();
+    options.overflow = testing::TempDir();
+    options.segment = 1024;
+
+    multiqueue::MultiQueueProcessor<std::string, std::string> processor(options);
+    // No subscriber, so messages stay in the processor.
+    for (auto i = 0; i < 5000; ++i)
+    {
+        ASSERT_NO_THROW(processor.Enqueue("1", std::to_string(i)));
+    }
+    ASSERT_TRUE(processor.Size("1") == 5000);
+
+    for (auto i = 0; i < 5000; ++i)
+    {
+        ASSERT_TRUE(processor.Dequeue("1") == std::to_string(i));
+    }
+    ASSERT_TRUE(processor.Size("1") == 0);
+
+    options.codec = nullptr;
+    ASSERT_THROW((multiqueue::MultiQueueProcessor<std::string, std::string>(options)), std::invalid_argument);
+}
+
+TEST(TestSpill, dispatch)
+{
+    multiqueue::Options<std::string, std::string> options;
+    options.capacity = 10;
+    options.codec = std::make_shared<faulty_codec>();
+    options.overflow = testing::TempDir();
+
+    multiqueue::MultiQueueProcessor<std::string, std::string> processor(options);
+    counting_consumer consumer;
+
+    for (auto i = 0; i < 20; ++i) { processor.Enqueue("1", i == 15 ? "retry" : std::to_string(i)); }
+    // The message of the overflow fails to decode, it is dropped and the key is dispatched further.
+    processor.Subscribe("1", &consumer);
+
+    while (consumer.count != 19) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    processor.Enqueue("1", "20");
+
+    while (consumer.count != 20) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    ASSERT_TRUE(processor.Size("1") == 0);
+
+    processor.StopProcessing();
+    processor.Wait();
+}
+#else
+TEST(TestSpill, unsupported)
+{
+    multiqueue::Options<std::string, std::string> options;
+    options.codec = std::make_shared<string_codec>();
+    options.overflow = testing::TempDir();
+    // The overflow needs POSIX, so it is rejected rather than ignored.
+    ASSERT_THROW((multiqueue::MultiQueueProcessor<std::string, std::string>(options)), std::invalid_argument);
+}
+#endif // MULTIQUEUE_STORAGE
+//-------------------------------------------------------------------------//
+#endif // __GTEST_SPILL_H_4C8E2A17_D5B3_4F69_A0E1_93B7F2C60D58__
@@ -0,0 +1,101 @@
+/*!==========================================================================
+* \file
+* - Program:       gtest-multiqueue
+* - File:          gtest-trace.h
+* - Created:       10/19/2026
+* - Author:        Vitaly Bulganin
+* - Description:
+* - Comments:
+*
+-----------------------------------------------------------------------------
+*
+* - History:
+*
+===========================================================================*/
+#pragma once
+//-------------------------------------------------------------------------//
+#ifndef __GTEST_TRACE_H_3B7F0D26_C91A_4E58_8A4D_E60F2B51C9A7__
+#define __GTEST_TRACE_H_3B7F0D26_C91A_4E58_8A4D_E60F2B51C9A7__
+//-------------------------------------------------------------------------//
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+//-------------------------------------------------------------------------//
+#include <gtest/gtest.h>
+//-------------------------------------------------------------------------//
+#include "../../MultiQueueProcessor.h"
+//-------------------------------------------------------------------------//
+namespace
+{
+    class traced_consumer : public multiqueue::IConsumer<int, int>
+    {
+    public:
+        //!< Keeps a count of messages.
+        std::atomic_int count;
+
+        traced_consumer() : count(0) {}
+
+        virtual auto Consume(const int &, const int &) -> void override { ++this->count; }
+    };
+
+    auto occurrences(const std::string & text, const std::string & pattern) -> size_t
+    {
+        size_t count = 0;
+
+        for (auto position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1)) { ++count; }
+
+        return count;
+    }
+}; // namespace
+//-------------------------------------------------------------------------//
+TEST(TestTrace, timeline)
+{
+    using trace_t = multiqueue::diagnostics::trace;
+
+    multiqueue::MultiQueueProcessor<int, int> processor;
+    traced_consumer consumer;
+
+    trace_t::clear();
+    trace_t::enable(true);
+
+    processor.Subscribe(1, &consumer);
+
+    for (auto i = 0; i < 100; ++i) { processor.Enqueue(1, i); }
+    while (consumer.count != 100) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+    processor.Enqueue(2, 0);
+    processor.Dequeue(2);
+    // Tasks are recorded, when dispatching threads are finished.
+    processor.StopProcessing();
+    processor.Wait();
+
+    trace_t::enable(false);
+    // Events are not recorded anymore.
+    processor.Enqueue(2, 0);
+
+    std::ostringstream stream;
+    trace_t::dump(stream);
+    const auto text = stream.str();
+
+    ASSERT_TRUE(text.find("{\"traceEvents\":[") == 0);
+#ifdef MULTIQUEUE_NO_TRACE
+    // Tracing is compiled out, so nothing is recorded.
+    ASSERT_TRUE(occurrences(text, "\"cat\":\"multiqueue\"") == 0);
+#else
+    ASSERT_TRUE(occurrences(text, "\"name\":\"enqueue\"") == 101);
+    ASSERT_TRUE(occurrences(text, "\"name\":\"dequeue\"") == 1);
+    ASSERT_TRUE(occurrences(text, "\"name\":\"claim\"") == 100);
+    ASSERT_TRUE(occurrences(text, "\"name\":\"consume\"") == 100);
+    ASSERT_TRUE(occurrences(text, "\"name\":\"task\"") >= 1);
+#endif // MULTIQUEUE_NO_TRACE
+
+    trace_t::clear();
+
+    std::ostringstream cleared;
+    trace_t::dump(cleared);
+    ASSERT_TRUE(occurrences(cleared.str(), "\"name\":\"enqueue\"") == 0);
+}
+//-------------------------------------------------------------------------//
+#endif // __GTEST_TRACE_H_3B7F0D26_C91A_4E58_8A4D_E60F2B51C9A7__